@@ -0,0 +1,77 @@
+/**
+ * @file Ack_policy.hpp
+ * @author KalecKKK
+ * @brief 按周期决定每条命令请求的应答类型，减少应答帧占用的总线带宽
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 大多数周期发送 NO_ACK，每 interval 个周期请求一次完整应答；
+ * 跟踪误差超限、温度上升过快或电机报错时立即请求应答，直到状态恢复。
+ * 每个电机一个实例。
+ */
+
+#pragma once
+
+#include "Motor_control.hpp"
+#include <stdint.h>
+
+namespace Motor {
+
+class Ack_policy {
+protected:
+  uint32_t interval;
+  Message_return_status ack_type;
+
+  float tracking_threshold;
+  int temperature_threshold;
+  uint32_t temperature_window;
+
+  uint64_t cycle, last_ack_cycle, ack_count;
+
+  bool fault, temperature_rising, has_temperature;
+  uint8_t reference_temperature;
+  uint64_t reference_cycle;
+
+public:
+  /**
+   * @param interval 每隔多少个周期请求一次应答，1 表示每周期都请求
+   * @param ack_type 请求的应答类型
+   */
+  Ack_policy(uint32_t interval = 10,
+             Message_return_status ack_type = ACK_TYPE_1);
+
+  /**
+   * @brief 跟踪误差绝对值超过阈值时立即请求应答
+   */
+  void SetTrackingThreshold(float threshold);
+
+  /**
+   * @brief window 个周期内温度上升达到 threshold 时每周期请求应答
+   * @param threshold 温度上升量，与 Motor_info::motor_temperature 单位相同
+   * @param window 统计窗口，单位为周期
+   */
+  void SetTemperatureThreshold(int threshold, uint32_t window);
+
+  /**
+   * @brief 决定本周期命令的应答类型，每周期调用一次
+   * @param tracking_error 本周期的跟踪误差
+   */
+  Message_return_status Next(float tracking_error = 0);
+
+  /**
+   * @brief 收到应答后更新温度趋势与故障状态
+   */
+  void Observe(const Motor_control::Motor_info &info);
+
+  uint64_t CycleCount() const { return cycle; }
+  uint64_t AckCount() const { return ack_count; }
+
+  /**
+   * @brief 无异常时请求应答的周期比例，用于总线带宽预算
+   */
+  double NominalAckRatio() const { return 1.0 / interval; }
+};
+
+} // namespace Motor
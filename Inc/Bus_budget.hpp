@@ -0,0 +1,129 @@
+/**
+ * @file Bus_budget.hpp
+ * @author KalecKKK
+ * @brief 总线带宽预算：按最坏位填充计算每帧占用时间，配置阶段检查总线利用率
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 1 Mbit/s 下 3~8 字节数据帧加位填充约占 85~135 µs，
+ * 每个控制周期能发送的帧数有硬上限。控制环配置好后调用 Check，
+ * 超出目标利用率时告警或抛出异常，而不是运行时表现为延迟抖动。
+ */
+
+#pragma once
+
+#include "Can_transport.hpp"
+#include <stdint.h>
+#include <vector>
+
+namespace EcanVci {
+
+enum Budget_policy {
+  BUDGET_WARN = 0x00,   // 超出时只告警
+  BUDGET_REJECT = 0x01, // 超出时抛出异常
+};
+
+/**
+ * @brief 周期性帧，request 与 reply 为一次收发的数据长度，reply 为 0 表示无应答
+ */
+struct Bus_load_entry {
+  const char *label; // 只保存指针，须在本对象存续期间有效
+  uint8_t request_len;
+  uint8_t reply_len;
+  bool extended;
+  double rate_hz;
+  uint32_t count;
+};
+
+class Bus_budget {
+protected:
+  uint32_t bitrate;
+  double target_utilization;
+  std::vector<Bus_load_entry> entries;
+
+public:
+  /**
+   * @brief 由 BTR0/BTR1 计算波特率（SJA1000 时序，16 MHz 时钟）
+   * @return uint32_t bit/s
+   */
+  static constexpr uint32_t Bitrate(uint8_t timing0, uint8_t timing1) {
+    uint32_t prescaler = 2 * ((timing0 & 0x3F) + 1);
+    uint32_t quanta = 1 + ((timing1 & 0x0F) + 1) + (((timing1 >> 4) & 0x07) + 1);
+    return 16000000 / (prescaler * quanta);
+  }
+
+  /**
+   * @brief 最坏情况下一帧占用的位数，含位填充与 3 位帧间隔
+   * @param data_len 数据长度 0~8
+   * @param extended 是否为 29 位扩展帧
+   */
+  static constexpr uint32_t FrameBits(uint8_t data_len, bool extended = false) {
+    // 参与位填充的部分：标准帧 34 位、扩展帧 54 位加数据区，
+    // 每 4 位最多插入一个填充位；不参与填充的 CRC 界定符、ACK、EOF 与帧间隔共 13 位
+    uint32_t stuffed = (extended ? 54u : 34u) + 8u * data_len;
+    return stuffed + 13 + (stuffed - 1) / 4;
+  }
+
+  /**
+   * @brief 最坏情况下一帧占用的时间
+   * @return double µs
+   */
+  double FrameTime(uint8_t data_len, bool extended = false) const;
+
+  /**
+   * @param bitrate 总线波特率 bit/s
+   * @param target_utilization 目标利用率，0~1
+   */
+  Bus_budget(uint32_t bitrate, double target_utilization = 0.7);
+
+  /**
+   * @brief 使用传输层配置的波特率
+   */
+  explicit Bus_budget(const Can_transport &transport,
+                      double target_utilization = 0.7);
+
+  uint32_t BusBitrate() const { return bitrate; }
+
+  /**
+   * @brief 加入一类周期性收发
+   * @param label 名称，用于报告，一般为字符串字面量
+   * @param request_len 命令帧数据长度
+   * @param reply_len 应答帧数据长度，无应答为 0
+   * @param rate_hz 每个设备的发送频率
+   * @param count 设备数量
+   * @param extended 是否为扩展帧
+   */
+  void AddExchange(const char *label, uint8_t request_len,
+                   uint8_t reply_len, double rate_hz, uint32_t count = 1,
+                   bool extended = false);
+
+  void Clear();
+
+  /**
+   * @brief 每秒占用的总线时间
+   * @return double 利用率，0~1，超过 1 表示总线无法承载
+   */
+  double Utilization() const;
+
+  /**
+   * @brief 在目标利用率内，按给定收发还能容纳的设备数量
+   */
+  uint32_t Headroom(uint8_t request_len, uint8_t reply_len, double rate_hz,
+                    bool extended = false) const;
+
+  /**
+   * @brief 检查利用率
+   * @param policy 超出时告警或抛出异常
+   * @return DWORD 未超出返回 STATUS_OK
+   */
+  DWORD Check(Budget_policy policy = BUDGET_WARN) const;
+
+  /**
+   * @brief 把每类收发的占用写入日志
+   */
+  void Report() const;
+};
+
+} // namespace EcanVci
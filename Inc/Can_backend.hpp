@@ -0,0 +1,117 @@
+/**
+ * @file Can_backend.hpp
+ * @author KalecKKK
+ * @brief CAN 收发后端的概念约束与类型擦除句柄
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 满足 Can_backend 的类型（Can_transport、Motord_client 等）可直接作为
+ * Basic_motor_control 的模板参数，热路径上的收发为静态调用。
+ * 运行时才确定后端时使用 Can_backend_handle，每次收发多一次间接调用。
+ */
+
+#pragma once
+
+#include "ECanVci.h"
+#include <concepts>
+#include <stdint.h>
+#include <vector>
+
+namespace EcanVci {
+
+/**
+ * @brief 驱动时间戳单位为 0.1 ms，转换为 us，帧未带时间戳时为 0
+ */
+constexpr uint64_t DeviceTimestamp(const CAN_OBJ &msg) {
+  return msg.TimeFlag ? static_cast<uint64_t>(msg.TimeStamp) * 100 : 0;
+}
+
+template <typename T>
+concept Can_backend = requires(const T &backend, CAN_OBJ msgs[], ULONG len,
+                               INT wait_time, const CAN_OBJ &msg,
+                               ERR_INFO &error) {
+  // 批量发送，返回实际发送的帧数量
+  { backend.Transmit(msgs, len) } -> std::same_as<DWORD>;
+  // 批量接收，最多等待 wait_time ms，返回实际接收的帧数量
+  { backend.Receive(msgs, len, wait_time) } -> std::same_as<DWORD>;
+  // 接收帧的时间戳 us
+  { backend.Timestamp(msg) } -> std::same_as<uint64_t>;
+  // 读取并清除错误信息
+  { backend.ReadError(error) } -> std::same_as<DWORD>;
+};
+
+/**
+ * @brief 可由内核或驱动按电机 ID 过滤接收帧的后端，如 Socket_can_transport
+ */
+template <typename T>
+concept Can_filter_backend =
+    requires(const T &backend, const std::vector<uint16_t> &ids) {
+      // 只接收这些电机与 0x7FF 的帧，为空表示接收全部
+      { backend.SetFilter(ids) } -> std::same_as<DWORD>;
+    };
+
+/**
+ * @brief 任意 Can_backend 的引用，不持有后端，后端须比句柄活得久
+ */
+class Can_backend_handle {
+protected:
+  const void *backend;
+  DWORD (*transmit)(const void *backend, CAN_OBJ msgs[], ULONG len);
+  DWORD (*receive)(const void *backend, CAN_OBJ msgs[], ULONG len,
+                   INT wait_time);
+  uint64_t (*timestamp)(const void *backend, const CAN_OBJ &msg);
+  DWORD (*read_error)(const void *backend, ERR_INFO &error);
+  // 后端不支持接收过滤时为 nullptr
+  DWORD (*set_filter)(const void *backend, const std::vector<uint16_t> &ids);
+
+public:
+  template <typename T>
+    requires(!std::same_as<T, Can_backend_handle> && Can_backend<T>)
+  Can_backend_handle(const T &backend)
+      : backend(&backend),
+        transmit([](const void *b, CAN_OBJ msgs[], ULONG len) {
+          return static_cast<const T *>(b)->Transmit(msgs, len);
+        }),
+        receive([](const void *b, CAN_OBJ msgs[], ULONG len, INT wait_time) {
+          return static_cast<const T *>(b)->Receive(msgs, len, wait_time);
+        }),
+        timestamp([](const void *b, const CAN_OBJ &msg) {
+          return static_cast<const T *>(b)->Timestamp(msg);
+        }),
+        read_error([](const void *b, ERR_INFO &error) {
+          return static_cast<const T *>(b)->ReadError(error);
+        }),
+        set_filter(nullptr) {
+    if constexpr (Can_filter_backend<T>) {
+      set_filter = [](const void *b, const std::vector<uint16_t> &ids) {
+        return static_cast<const T *>(b)->SetFilter(ids);
+      };
+    }
+  }
+
+  DWORD Transmit(CAN_OBJ msgs[], ULONG len) const {
+    return transmit(backend, msgs, len);
+  }
+  DWORD Receive(CAN_OBJ msgs[], ULONG len, INT wait_time = 0) const {
+    return receive(backend, msgs, len, wait_time);
+  }
+  uint64_t Timestamp(const CAN_OBJ &msg) const {
+    return timestamp(backend, msg);
+  }
+  DWORD ReadError(ERR_INFO &error) const { return read_error(backend, error); }
+
+  /**
+   * @brief 更新后端的接收过滤，后端不支持时接收全部帧，返回 STATUS_OK
+   */
+  DWORD SetFilter(const std::vector<uint16_t> &ids) const {
+    return set_filter ? set_filter(backend, ids) : STATUS_OK;
+  }
+};
+
+static_assert(Can_filter_backend<Can_backend_handle>);
+
+static_assert(Can_backend<Can_backend_handle>);
+
+} // namespace EcanVci
@@ -0,0 +1,203 @@
+/**
+ * @file Can_capture.hpp
+ * @author KalecKKK
+ * @brief CAN 收发帧二进制抓包（内存映射环形文件）与确定性回放
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include "ECanVci.h"
+#include <atomic>
+#include <cstring>
+#include <ctime>
+#include <stdint.h>
+#include <string>
+
+namespace EcanVci {
+
+enum Capture_flag : uint8_t {
+  CAPTURE_RX = 0x01,
+  CAPTURE_EXTERN = 0x02,
+  CAPTURE_REMOTE = 0x04,
+  CAPTURE_TIME = 0x08,
+};
+
+/**
+ * @brief 定长抓包记录（32 字节）
+ * sequence 为写入序号的低 32 位加一，写入过程中为 0，读端据此丢弃被覆盖或未写完的记录
+ */
+struct Capture_record {
+  uint64_t host_timestamp;   // 主机 CLOCK_MONOTONIC，单位 ns
+  uint32_t device_timestamp; // CAN_OBJ::TimeStamp
+  uint32_t id;
+  uint8_t data[8];
+  uint8_t data_len;
+  uint8_t flags;   // Capture_flag 组合
+  uint8_t channel; // device_index << 1 | can_index
+  uint8_t reserved;
+  uint32_t sequence;
+};
+static_assert(sizeof(Capture_record) == 32, "Capture_record must be 32 bytes");
+
+/**
+ * @brief 抓包文件头（64 字节），紧跟 capacity 条 Capture_record
+ */
+struct Capture_header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t record_size;
+  uint64_t capacity;
+  std::atomic<uint64_t> write_index;
+  uint64_t start_monotonic; // 创建时的 CLOCK_MONOTONIC，单位 ns
+  uint64_t start_realtime;  // 创建时的 CLOCK_REALTIME，单位 ns
+  uint8_t reserved[24];
+};
+static_assert(sizeof(Capture_header) == 64, "Capture_header must be 64 bytes");
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+/**
+ * @brief 抓包写入端，多个 Can_transport 可共享同一个实例
+ */
+class Can_capture {
+protected:
+  int fd;
+  Capture_header *header;
+  Capture_record *records;
+  uint64_t mask;
+  size_t mapped_size;
+
+public:
+  /**
+   * @brief 打开或创建抓包文件，文件已存在且容量一致时接着写
+   * @param path 文件路径
+   * @param capacity 记录条数，向上取整到 2 的幂
+   */
+  Can_capture(const std::string &path, uint64_t capacity = 1 << 20);
+
+  ~Can_capture();
+
+  Can_capture(const Can_capture &) = delete;
+  Can_capture &operator=(const Can_capture &) = delete;
+
+  /**
+   * @brief 记录一批帧
+   * @param flags 方向标志，CAPTURE_RX 或 0
+   * @param channel 通道号
+   * @param msgs 帧数组
+   * @param len 帧数量
+   */
+  void Record(uint8_t flags, uint8_t channel, const CAN_OBJ msgs[],
+              ULONG len) const {
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t host_timestamp =
+        static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+    uint64_t index =
+        header->write_index.fetch_add(len, std::memory_order_relaxed);
+    for (ULONG i = 0; i < len; i++, index++) {
+      Capture_record &record = records[index & mask];
+      std::atomic_ref<uint32_t> sequence(record.sequence);
+      sequence.store(0, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      record.host_timestamp = host_timestamp;
+      record.device_timestamp = msgs[i].TimeStamp;
+      record.id = msgs[i].ID;
+      memcpy(record.data, msgs[i].Data, 8);
+      record.data_len = msgs[i].DataLen;
+      record.flags = flags | (msgs[i].ExternFlag ? CAPTURE_EXTERN : 0) |
+                     (msgs[i].RemoteFlag ? CAPTURE_REMOTE : 0) |
+                     (msgs[i].TimeFlag ? CAPTURE_TIME : 0);
+      record.channel = channel;
+      sequence.store(static_cast<uint32_t>(index) + 1,
+                     std::memory_order_release);
+    }
+  }
+
+  /**
+   * @brief 已写入的记录总数（含已被覆盖的）
+   */
+  uint64_t Count() const;
+};
+
+enum Replay_speed {
+  REPLAY_ORIGINAL_SPEED = 0x00,
+  REPLAY_AS_FAST_AS_POSSIBLE = 0x01,
+};
+
+/**
+ * @brief 抓包回放端，作为 Can_transport 的回放后端使用
+ *
+ * 接收：跳过游标处的发送记录，返回紧随其后连续的一段接收记录，
+ * 即原始运行中两次发送之间收到的帧，回放结果与调用方的时序无关。
+ * 原速模式下只返回到期的帧，wait_time 内没有到期帧则返回 0。
+ */
+class Can_replay {
+protected:
+  int fd;
+  const Capture_header *header;
+  const Capture_record *records;
+  uint64_t mask;
+  size_t mapped_size;
+
+  Replay_speed speed;
+  int channel;
+
+  uint64_t begin, end, cursor, tx_cursor;
+  uint64_t first_timestamp;
+  timespec start_time;
+
+  uint64_t transmitted, mismatched;
+
+  bool Load(uint64_t index, Capture_record &record) const;
+  bool Match(const Capture_record &record) const;
+
+public:
+  /**
+   * @brief 打开抓包文件
+   * @param path 文件路径
+   * @param speed 回放速度
+   * @param channel 只回放该通道，-1 表示全部
+   */
+  Can_replay(const std::string &path,
+             Replay_speed speed = REPLAY_ORIGINAL_SPEED, int channel = -1);
+
+  ~Can_replay();
+
+  Can_replay(const Can_replay &) = delete;
+  Can_replay &operator=(const Can_replay &) = delete;
+
+  /**
+   * @brief 从头开始回放
+   */
+  void Rewind();
+
+  /**
+   * @brief 是否已回放完毕
+   */
+  bool Finished() const;
+
+  /**
+   * @brief 取出下一段接收帧
+   * @return DWORD 帧数量
+   */
+  DWORD Receive(CAN_OBJ msgs[], ULONG len, INT wait_time);
+
+  /**
+   * @brief 比对发送帧与抓包中的发送记录
+   * @return DWORD 帧数量
+   */
+  DWORD Transmit(const CAN_OBJ msgs[], ULONG len);
+
+  /**
+   * @brief 已发送帧数 / 与记录不一致的帧数
+   */
+  uint64_t TransmittedCount() const { return transmitted; }
+  uint64_t MismatchedCount() const { return mismatched; }
+};
+
+} // namespace EcanVci
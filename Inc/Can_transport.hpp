@@ -11,7 +11,11 @@
 
 #pragma once
 
+#include "Can_backend.hpp"
+#include "Can_capture.hpp"
 #include "ECanVci.h"
+#include <memory>
+#include <vector>
 
 namespace EcanVci {
 
@@ -56,19 +60,110 @@ enum CAN_ID {
   CAN_2 = 0x01,
 };
 
+struct Channel_config {
+  DWORD device_type;
+  DWORD device_index;
+  CAN_ID can_index;
+  Tim0Kbps timing0 = TIM0_KBPS_1000;
+  Tim1Kbps timing1 = TIM1_KBPS_1000;
+};
+
 class Can_transport {
 protected:
   DWORD device_type, device_index;
 
   CAN_ID can_index;
 
+  Tim0Kbps timing0;
+  Tim1Kbps timing1;
+
+  const Can_capture *capture;
+  Can_replay *replay;
+
+  uint8_t Channel() const {
+    return static_cast<uint8_t>(device_index << 1 | can_index);
+  }
+
 public:
   Can_transport();
   Can_transport(CAN_ID can_index);
-  Can_transport(DWORD device_type, DWORD device_index, CAN_ID can_index);
+
+  /**
+   * @brief 打开并启动通道，以指数退避探测设备与控制器就绪，不固定等待
+   * @note 同一适配器的多个通道共用一次 OpenDevice，最后一个通道析构时关闭设备
+   */
+  Can_transport(DWORD device_type, DWORD device_index, CAN_ID can_index,
+                Tim0Kbps timing0 = TIM0_KBPS_1000,
+                Tim1Kbps timing1 = TIM1_KBPS_1000);
+
+  /**
+   * @brief 并行打开多个通道
+   * @param configs 通道配置
+   * @return std::vector<std::unique_ptr<Can_transport>> 与 configs 顺序相同
+   * @note 任一通道失败时抛出 std::runtime_error，其余已打开的通道随之关闭
+   */
+  static std::vector<std::unique_ptr<Can_transport>>
+  OpenAll(const std::vector<Channel_config> &configs);
+
+  /**
+   * @brief 回放模式构造函数，不打开设备，收发均由抓包文件驱动
+   * @param replay 回放后端
+   * @param can_index 通道号
+   */
+  explicit Can_transport(Can_replay &replay, CAN_ID can_index = CAN_1);
 
   ~Can_transport();
 
+  /**
+   * @brief 所属适配器，同一适配器的各通道相同
+   */
+  uint32_t Device() const { return device_type << 16 | device_index; }
+
+  Tim0Kbps Timing0() const { return timing0; }
+  Tim1Kbps Timing1() const { return timing1; }
+
+  /**
+   * @brief 由配置的 Timing0/Timing1 换算的波特率
+   * @return uint32_t bit/s
+   */
+  uint32_t Bitrate() const;
+
+  /**
+   * @brief 挂载抓包，之后所有收发帧都写入抓包文件
+   * @param capture 抓包写入端，nullptr 表示关闭
+   */
+  void AttachCapture(const Can_capture *capture);
+
+  /**
+   * @brief 批量发送
+   * @param msgs 帧数组
+   * @param len 帧数量
+   * @return DWORD 实际发送的帧数量
+   */
+  DWORD Transmit(CAN_OBJ msgs[], ULONG len) const;
+
+  /**
+   * @brief 批量接收
+   * @param msgs 帧数组
+   * @param len 最多接收的帧数量
+   * @param wait_time 等待时间 ms
+   * @return DWORD 实际接收的帧数量
+   */
+  DWORD Receive(CAN_OBJ msgs[], ULONG len, INT wait_time = 0) const;
+
+  /**
+   * @brief 接收帧的硬件时间戳
+   * @return uint64_t us，帧未带时间戳时为 0
+   */
+  uint64_t Timestamp(const CAN_OBJ &msg) const { return DeviceTimestamp(msg); }
+
+  /**
+   * @brief 读取并清除通道的错误信息，回放时总是无错误
+   * @param error 输出错误信息
+   * @return DWORD STATUS_OK 或 STATUS_ERR
+   */
+  DWORD ReadError(ERR_INFO &error) const;
+
   DWORD Transmit(UINT destination, BYTE data[], ULONG len) const;
   DWORD ReceiveOnce(UINT &source, BYTE data[], ULONG &len,
                     ULONG wait_time = 0) const;
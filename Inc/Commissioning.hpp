@@ -0,0 +1,101 @@
+/**
+ * @file Commissioning.hpp
+ * @author KalecKKK
+ * @brief 电机组上电调试：重置与分配 ID、设零位、设置通信模式
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 每个电机一个协程，按 重置 ID → 分配 ID → 设零位 → 设置通信模式 → 确认
+ * 的顺序推进，每一步都等待 0x7FF 反馈帧确认（重置成功 0x05、ID 查询 0x01、
+ * 查询失败 0x80），不再固定等待。各电机的协程在同一执行器上并发运行，
+ * 超时按电机的最大重试次数重发。
+ *
+ *   Motor::Async_executor executor(can_transport);
+ *   executor.Attach(motor);
+ *   Motor::Commissioning commissioning(executor);
+ *   commissioning.Add(motor, {.from_id = 0x01, .set_zero = true});
+ *   uint32_t failed = commissioning.Run();
+ */
+
+#pragma once
+
+#include "Motor_control.hpp"
+#include <chrono>
+#include <optional>
+#include <stdint.h>
+#include <vector>
+
+namespace Motor {
+
+enum Commission_step : uint8_t {
+  STEP_RESET_ID = 0x00,
+  STEP_ASSIGN_ID = 0x01,
+  STEP_SET_ZERO = 0x02,
+  STEP_SET_MODE = 0x03,
+  STEP_VERIFY = 0x04,
+  STEP_DONE = 0x05,
+};
+
+struct Commission_plan {
+  // 先广播恢复出厂 ID 1，总线上只能有这一个电机，也只能有这一项调试
+  bool reset_id = false;
+  // 电机当前的 ID，为空表示已是目标 ID；reset_id 时忽略
+  std::optional<uint16_t> from_id = std::nullopt;
+  bool set_zero = false;
+  // UNKOWN 表示不修改
+  Communication_mode mode = Communication_mode::UNKOWN;
+};
+
+struct Commission_result {
+  uint16_t motor_id;
+  Commission_step step; // 成功时为 STEP_DONE，失败时为失败的步骤
+  std::chrono::microseconds elapsed;
+};
+
+class Commissioning {
+protected:
+  struct Entry {
+    Motor_core *motor;
+    Commission_plan plan;
+    Commission_result result;
+  };
+
+  Async_executor &executor;
+  std::vector<Entry> entries;
+
+  Task<void> Commission(Entry &entry);
+
+public:
+  /**
+   * @param executor 已登记所有电机的执行器
+   */
+  explicit Commissioning(Async_executor &executor);
+
+  /**
+   * @brief 加入电机，ID 为调试完成后的目标 ID
+   * @note 重置 ID 的电机不是唯一一项，或当前 ID 冲突时抛出 std::runtime_error
+   */
+  void Add(Motor_core &motor, const Commission_plan &plan);
+
+  /**
+   * @brief 把所有电机的调试任务交给执行器，由调用方运行执行器
+   */
+  void Schedule();
+
+  /**
+   * @brief Schedule 后运行执行器直到所有任务结束
+   * @return uint32_t 失败的电机数量
+   */
+  uint32_t Run();
+
+  size_t Size() const { return entries.size(); }
+  const Commission_result &Result(size_t index) const {
+    return entries.at(index).result;
+  }
+
+  static const char *StepName(Commission_step step);
+};
+
+} // namespace Motor
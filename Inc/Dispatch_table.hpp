@@ -0,0 +1,85 @@
+/**
+ * @file Dispatch_table.hpp
+ * @author KalecKKK
+ * @brief 按 CAN ID 把接收帧直接映射到电机，每帧常数时间
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 11 位标准帧使用 2048 项的稠密表，29 位扩展帧使用哈希表。
+ * 0x7FF 管理帧不属于任何电机，由调用方交给应答关联层。
+ */
+
+#pragma once
+
+#include "ECanVci.h"
+#include <array>
+#include <cstddef>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace Motor {
+
+class Motor_core;
+
+class Dispatch_table {
+public:
+  struct Entry {
+    Motor_core *motor;
+    uint32_t slot; // 调用方的状态槽，如遥测槽或电机组中的下标
+  };
+
+  static constexpr UINT MANAGEMENT_ID = 0x7FF;
+
+protected:
+  std::array<Entry, 2048> standard;
+  std::unordered_map<UINT, Entry> extended;
+
+public:
+  Dispatch_table();
+
+  /**
+   * @brief 登记电机，键为其 ID
+   * @param motor 电机
+   * @param slot 状态槽
+   * @param is_extended 是否为 29 位扩展帧
+   * @return DWORD ID 已被占用或为 0x7FF 时返回 STATUS_ERR
+   */
+  DWORD Register(Motor_core &motor, uint32_t slot = 0,
+                 bool is_extended = false);
+
+  /**
+   * @brief 注销电机
+   */
+  void Unregister(const Motor_core &motor);
+
+  static bool IsManagement(const CAN_OBJ &msg) {
+    return !msg.ExternFlag && msg.ID == MANAGEMENT_ID;
+  }
+
+  /**
+   * @brief 查找帧所属的电机
+   * @return const Entry* 未登记或为管理帧时返回 nullptr
+   */
+  const Entry *Find(const CAN_OBJ &msg) const {
+    if (!msg.ExternFlag && msg.ID < standard.size()) {
+      const Entry &entry = standard[msg.ID];
+      return entry.motor ? &entry : nullptr;
+    }
+    auto it = extended.find(msg.ID);
+    return it == extended.end() ? nullptr : &it->second;
+  }
+
+  size_t Size() const;
+
+  /**
+   * @brief 后端接收过滤使用的电机 ID
+   * @return std::vector<uint16_t> 已登记的标准帧 ID；登记了扩展帧电机时
+   *         过滤无法表示，返回空（接收全部）
+   */
+  std::vector<uint16_t> FilterIds() const;
+};
+
+} // namespace Motor
@@ -0,0 +1,147 @@
+/**
+ * @file Estimator_bank.hpp
+ * @author KalecKKK
+ * @brief 多轴状态估计：α-β 滤波位置与速度，并外推到下一个命令时刻
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 应答帧中的速度只有 12 位，位置到达上位机时已晚一个 USB 往返。
+ * 每个轴按带时间戳的反馈做匀速模型的 α-β 滤波（即稳态卡尔曼滤波），
+ * 两次反馈的间隔按时间戳计算；Predict 把估计外推到给定时刻，
+ * 控制器使用补偿了延迟的状态。滤波与外推调用 Simd 内核一遍算完所有轴。
+ * 时间戳与 Feedback_batch::timestamp 同一时钟，单位 us。
+ *
+ *   Motor::Estimator_bank estimator;
+ *   auto config = Motor::Estimator_config::FromNoise(50.0f, 1e-3f, 0.001f);
+ *   estimator.Add(motor, config);
+ *   // 每周期
+ *   Motor::DecodeFeedback<Motor::Encos_standard>(msgs, count, feedback,
+ *                                                can_transport);
+ *   estimator.Update(feedback);
+ *   estimator.Predict(estimator.Latest() + latency);
+ *   fleet.UpdateFeedback(estimator);
+ */
+
+#pragma once
+
+#include "Feedback_batch.hpp"
+#include "Motor_control.hpp"
+#include <array>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace Motor {
+
+constexpr uint32_t ESTIMATOR_SIZE = 256;
+
+struct Estimator_config {
+  // 位置残差增益 α 与速度残差增益 β（乘以 1 / dt）
+  float alpha, beta;
+  // 速度测量的融合权重，0 时只由位置估计速度
+  float speed_weight = 0.0f;
+  // 两次反馈间隔超过时以测量值重新初始化 s
+  float reset_gap = 0.05f;
+
+  /**
+   * @brief 按噪声求稳态卡尔曼增益（Kalata 跟踪指数）
+   * @param acceleration_noise 加速度扰动标准差 rad/s²
+   * @param position_noise 位置测量噪声标准差 rad
+   * @param period 反馈的标称周期 s
+   */
+  static Estimator_config FromNoise(float acceleration_noise,
+                                    float position_noise, float period);
+};
+
+class Estimator_bank {
+public:
+  struct Axes {
+    // 最近一次反馈时刻的估计
+    alignas(32) float position[ESTIMATOR_SIZE]; // rad
+    alignas(32) float speed[ESTIMATOR_SIZE];    // rad/s
+    // Predict 外推到命令时刻的位置，速度按匀速取 speed
+    alignas(32) float predicted_position[ESTIMATOR_SIZE]; // rad
+
+    alignas(32) float alpha[ESTIMATOR_SIZE];
+    alignas(32) float beta[ESTIMATOR_SIZE];
+    alignas(32) float speed_weight[ESTIMATOR_SIZE];
+
+    // 每次 Update 的内核输入，无新反馈的轴增益与 dt 为 0
+    alignas(32) float measured_position[ESTIMATOR_SIZE];
+    alignas(32) float measured_speed[ESTIMATOR_SIZE];
+    alignas(32) float dt[ESTIMATOR_SIZE];
+    alignas(32) float position_gain[ESTIMATOR_SIZE];
+    alignas(32) float speed_gain[ESTIMATOR_SIZE];
+    alignas(32) float weight[ESTIMATOR_SIZE];
+    alignas(32) float lead[ESTIMATOR_SIZE];
+  };
+
+  static constexpr uint16_t NO_AXIS = 0xFFFF;
+
+protected:
+  std::unique_ptr<Axes> axes;
+  std::vector<uint16_t> motor_ids;
+  std::vector<float> reset_gap;
+  // 估计对应的反馈时间戳 us，0 表示尚未初始化
+  std::vector<uint64_t> timestamp;
+  // 本次 Update 中各轴最新反馈的时间戳，0 表示无新反馈
+  std::vector<uint64_t> measured_at;
+  std::array<uint16_t, 2048> axis_of;
+  uint64_t latest;
+  uint64_t resets;
+
+public:
+  Estimator_bank();
+
+  /**
+   * @brief 加入一个轴
+   * @return uint32_t 轴下标，按加入顺序
+   * @note 轴数超过 ESTIMATOR_SIZE 或电机已加入时抛出 std::runtime_error
+   */
+  uint32_t Add(const Motor_core &motor, const Estimator_config &config);
+
+  uint32_t Size() const { return static_cast<uint32_t>(motor_ids.size()); }
+
+  const Axes &Data() const { return *axes; }
+
+  /**
+   * @brief 电机 ID 对应的轴下标，未加入时为 NO_AXIS
+   */
+  uint16_t Axis(uint16_t motor_id) const {
+    return motor_id < axis_of.size() ? axis_of[motor_id] : NO_AXIS;
+  }
+
+  void SetConfig(uint32_t axis, const Estimator_config &config);
+
+  /**
+   * @brief 丢弃估计，下一次反馈重新初始化
+   */
+  void Reset(uint32_t axis);
+
+  /**
+   * @brief 以一批解码后的反馈滤波，同一轴有多帧时取最新的一帧
+   * @return uint32_t 用于滤波或初始化的轴数，不带时间戳或
+   *         早于当前估计的帧被忽略
+   */
+  uint32_t Update(const Feedback_batch &batch);
+
+  /**
+   * @brief 把所有轴的估计外推到 timestamp，写入 predicted_position
+   * @param timestamp 命令发出的时刻 us，与反馈时间戳同一时钟
+   */
+  void Predict(uint64_t timestamp);
+
+  /**
+   * @brief 最近一次反馈的时间戳 us
+   */
+  uint64_t Latest() const { return latest; }
+
+  /**
+   * @brief 因间隔过长或首次反馈而初始化的次数
+   */
+  uint64_t Resets() const { return resets; }
+};
+
+} // namespace Motor
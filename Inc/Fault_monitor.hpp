@@ -0,0 +1,210 @@
+/**
+ * @file Fault_monitor.hpp
+ * @author KalecKKK
+ * @brief 故障快速通路：在接收路径检测错误码变化，实时发送路径立即反应
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 接收线程（ProcessFrame 或 Observe）发现电机错误码变化时写入无锁队列，
+ * 由非实时线程的 Dispatch 交给注册的处理函数；配置了反应的电机同时被锁存，
+ * 实时线程每周期在写完正常命令后调用 Stage，以零电流或制动帧原地替换
+ * 该电机在批次中的命令，该电机不再发出正常命令，直到 Clear。
+ * 批次为没有命令的电机保留位置（Frame_batch::Reserve），反应帧不会因批次满
+ * 而丢失。由 Transmit 发送批次，检测到反应帧发出的延迟在发出后测量；
+ * 批次未能发出反应帧时直接单独发送，延迟不超过检测后的下一次 Transmit。
+ *
+ *   Motor::Fault_monitor faults(std::chrono::microseconds(500));
+ *   faults.Add(motor, {.action = Motor::ACTION_BRAKE});
+ *   faults.AddHandler([](const Motor::Fault_event &event) { ... });
+ *   batch.Reserve(faults.Size());
+ *   // 实时线程每周期
+ *   fleet.Stage(batch);
+ *   faults.Stage(batch);
+ *   faults.Transmit(batch, can_transport);
+ *   // 非实时线程
+ *   faults.Dispatch();
+ */
+
+#pragma once
+
+#include "Feedback_batch.hpp"
+#include "Frame_batch.hpp"
+#include "Motor_control.hpp"
+#include "Spsc_ring.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace Motor {
+
+constexpr uint32_t FAULT_QUEUE_SIZE = 256;
+
+struct Fault_event {
+  uint16_t motor_id;
+  uint16_t slot;
+  ErrorCode previous, current; // current 为 NO_ERROR 表示恢复
+  uint64_t detected;           // CLOCK_MONOTONIC，单位 ns
+};
+
+enum Fault_action : uint8_t {
+  ACTION_NONE = 0x00,         // 只通知处理函数
+  ACTION_ZERO_CURRENT = 0x01, // 电流模式，电流 0
+  ACTION_BRAKE = 0x02,        // brake_mode 制动
+};
+
+struct Fault_reaction {
+  Fault_action action = ACTION_ZERO_CURRENT;
+  Control_mode brake_mode = VARIABEL_DAMPING_BRAKING;
+  float value = 0.0f; // 制动模式的电流或力矩，单位与 ControlWithMode 相同
+  Message_return_status ack_status = ACK_TYPE_1;
+};
+
+typedef std::function<void(const Fault_event &)> Fault_handler;
+
+/**
+ * @brief 处理函数关心的错误码，按 1 << ErrorCode 组合
+ */
+constexpr uint32_t FaultMask(ErrorCode code) { return 1u << code; }
+constexpr uint32_t ALL_FAULTS = 0xFFFFFFFF;
+
+class Fault_monitor {
+public:
+  static constexpr uint16_t NO_SLOT = 0xFFFF;
+
+protected:
+  struct Entry {
+    const Motor_core *motor;
+    Fault_reaction reaction;
+    std::atomic<uint8_t> last;      // 接收线程写
+    std::atomic<bool> latched;      // 接收线程置位，Clear 清除
+    std::atomic<uint64_t> detected; // 尚未反应的检测时刻，0 表示无
+
+    // 以下只由实时线程访问
+    uint64_t staged_detected; // 已暂存、待发出后计算延迟的检测时刻
+    CAN_OBJ frame;            // 本周期的反应帧
+    bool staged;
+  };
+
+  struct Handler {
+    uint32_t codes;
+    Fault_handler handler;
+  };
+
+  std::chrono::nanoseconds period;
+  std::vector<std::unique_ptr<Entry>> entries;
+  std::array<uint16_t, 2048> slot_of;
+  std::vector<Handler> handlers;
+  std::unique_ptr<Spsc_ring<Fault_event, FAULT_QUEUE_SIZE>> queue;
+  Frame_batch scratch; // 编码反应帧
+  uint32_t staged;
+
+  std::atomic<uint32_t> active;
+  std::atomic<uint64_t> dropped;
+  std::atomic<uint64_t> reactions, over_budget, max_latency, total_latency;
+
+public:
+  /**
+   * @param period 控制周期，检测到反应的延迟预算
+   */
+  explicit Fault_monitor(std::chrono::nanoseconds period);
+
+  Fault_monitor(const Fault_monitor &) = delete;
+  Fault_monitor &operator=(const Fault_monitor &) = delete;
+
+  /**
+   * @brief 加入一个电机并挂载到其 ProcessFrame，须在开始接收前调用
+   * @return uint32_t 槽下标
+   * @note 电机已加入时抛出 std::runtime_error
+   */
+  uint32_t Add(Motor_core &motor, const Fault_reaction &reaction = {});
+
+  /**
+   * @brief 注册处理函数，在 Dispatch 的线程中调用，须在开始接收前调用
+   * @param codes 关心的错误码，FaultMask 的组合，含 NO_ERROR 时也收到恢复事件
+   */
+  void AddHandler(Fault_handler handler, uint32_t codes = ALL_FAULTS);
+
+  uint32_t Size() const { return static_cast<uint32_t>(entries.size()); }
+
+  /**
+   * @brief 电机 ID 对应的槽，未加入时为 NO_SLOT
+   */
+  uint16_t Slot(uint16_t motor_id) const {
+    return motor_id < slot_of.size() ? slot_of[motor_id] : NO_SLOT;
+  }
+
+  /**
+   * @brief 接收线程：报告电机当前的错误码，变化时产生事件
+   * @return bool 错误码是否变化
+   * @note 所有 Observe 须来自同一个接收线程
+   */
+  bool Observe(uint32_t slot, ErrorCode code);
+
+  /**
+   * @brief 接收线程：以一批解码后的反馈检测
+   * @return uint32_t 产生的事件数
+   */
+  uint32_t Observe(const Feedback_batch &batch);
+
+  /**
+   * @brief 实时线程：以反应帧替换锁存电机在批次中的命令，无锁存时立即返回
+   * @note 须在本周期的正常命令写入之后调用
+   * @return uint32_t 写入的反应帧数量
+   */
+  uint32_t Stage(Frame_batch &batch);
+
+  /**
+   * @brief 实时线程：发送批次并测量反应延迟，批次未发出的反应帧单独发送
+   * @return DWORD 批次实际发送的帧数量
+   */
+  DWORD Transmit(Frame_batch &batch, EcanVci::Can_backend_handle can_transport);
+
+  /**
+   * @brief 非实时线程：把队列中的事件交给处理函数
+   * @return uint32_t 处理的事件数
+   */
+  uint32_t Dispatch();
+
+  /**
+   * @brief 解除锁存，停止发送反应帧
+   * @return DWORD 电机仍报错时返回 STATUS_ERR 且不解除
+   */
+  DWORD Clear(uint32_t slot);
+
+  bool Latched(uint32_t slot) const {
+    return entries[slot]->latched.load(std::memory_order_acquire);
+  }
+
+  uint32_t Active() const { return active.load(std::memory_order_relaxed); }
+
+  uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+  uint64_t Reactions() const {
+    return reactions.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 检测到反应帧发出的延迟超过一个控制周期的次数
+   */
+  uint64_t OverBudget() const {
+    return over_budget.load(std::memory_order_relaxed);
+  }
+
+  std::chrono::nanoseconds MaxLatency() const {
+    return std::chrono::nanoseconds(max_latency.load(std::memory_order_relaxed));
+  }
+
+  std::chrono::nanoseconds MeanLatency() const {
+    uint64_t count = Reactions();
+    return std::chrono::nanoseconds(
+        count ? total_latency.load(std::memory_order_relaxed) / count : 0);
+  }
+};
+
+} // namespace Motor
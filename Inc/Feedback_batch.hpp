@@ -0,0 +1,108 @@
+/**
+ * @file Feedback_batch.hpp
+ * @author KalecKKK
+ * @brief 把一次接收到的一批应答帧解码为国际单位的数组（SoA）
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 先逐帧筛出应答帧 1 并取出定点原始值，再用 Simd::Affine 整列换算，
+ * 位置、速度、电流与 Codec<Model>::DecodeAck 逐位一致，温度保留小数。
+ * 应答帧 2、3 为浮点值，不在此处理，仍由 Motor_control::ProcessFrame 逐帧解析。
+ * 每帧的接收时间戳默认取驱动时间戳，传入后端时由后端的 Timestamp 还原。
+ */
+
+#pragma once
+
+#include "Can_backend.hpp"
+#include "Motor_model.hpp"
+#include "Profiler.hpp"
+#include "Simd.hpp"
+#include <stdint.h>
+
+namespace Motor {
+
+constexpr uint32_t FEEDBACK_BATCH_SIZE = 256;
+
+struct Feedback_batch {
+  uint32_t count;
+  uint16_t motor_id[FEEDBACK_BATCH_SIZE];
+  uint8_t error_code[FEEDBACK_BATCH_SIZE];
+  uint64_t timestamp[FEEDBACK_BATCH_SIZE]; // us，帧未带时间戳时为 0
+
+  alignas(32) float position[FEEDBACK_BATCH_SIZE];          // rad
+  alignas(32) float speed[FEEDBACK_BATCH_SIZE];             // rad/s
+  alignas(32) float current[FEEDBACK_BATCH_SIZE];           // A
+  alignas(32) float motor_temperature[FEEDBACK_BATCH_SIZE]; // ℃
+  alignas(32) float MOS_temperature[FEEDBACK_BATCH_SIZE];   // ℃
+
+  // 定点原始值，解码的中间结果
+  alignas(32) int32_t raw[5][FEEDBACK_BATCH_SIZE];
+};
+
+namespace detail {
+
+template <typename Model, typename Timestamp>
+uint32_t DecodeFeedback(const CAN_OBJ msgs[], uint32_t len,
+                        Feedback_batch &batch, const Timestamp &timestamp) {
+  MOTOR_PROFILE_SCOPE(PHASE_DECODE);
+  using C = Codec<Model>;
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < len && n < FEEDBACK_BATCH_SIZE; i++) {
+    const CAN_OBJ &msg = msgs[i];
+    const BYTE *data = msg.Data;
+    if (msg.ID == 0x7FF || msg.ExternFlag || msg.DataLen < 8 ||
+        (data[0] >> 5) != 1) {
+      continue;
+    }
+    batch.motor_id[n] = static_cast<uint16_t>(msg.ID);
+    batch.error_code[n] = data[0] & 0b11111;
+    batch.timestamp[n] = timestamp(msg);
+    batch.raw[0][n] = data[1] << 8 | data[2];
+    batch.raw[1][n] = data[3] << 4 | data[4] >> 4;
+    batch.raw[2][n] = (data[4] & 0x0F) << 8 | data[5];
+    batch.raw[3][n] = data[6];
+    batch.raw[4][n] = data[7];
+    n++;
+  }
+  batch.count = n;
+
+  Simd::Affine(batch.raw[0], batch.position, n, C::POS_SCALE, Model::POS_MIN);
+  Simd::Affine(batch.raw[1], batch.speed, n, C::SPD_SCALE, Model::SPD_MIN);
+  Simd::Affine(batch.raw[2], batch.current, n, C::I_SCALE, Model::I_MIN);
+  // 温度 (raw - 50) / 2，不取整
+  Simd::Affine(batch.raw[3], batch.motor_temperature, n, 0.5f, -25.0f);
+  Simd::Affine(batch.raw[4], batch.MOS_temperature, n, 0.5f, -25.0f);
+  return n;
+}
+
+} // namespace detail
+
+/**
+ * @brief 解码一批帧中的应答帧 1，其余帧跳过
+ * @param msgs 接收到的帧
+ * @param len 帧数量
+ * @param batch 输出，超过 FEEDBACK_BATCH_SIZE 的部分丢弃
+ * @return uint32_t 解码的帧数量
+ */
+template <typename Model>
+uint32_t DecodeFeedback(const CAN_OBJ msgs[], uint32_t len,
+                        Feedback_batch &batch) {
+  return detail::DecodeFeedback<Model>(msgs, len, batch,
+                                       EcanVci::DeviceTimestamp);
+}
+
+/**
+ * @brief 同上，时间戳由接收这批帧的后端还原
+ */
+template <typename Model>
+uint32_t DecodeFeedback(const CAN_OBJ msgs[], uint32_t len,
+                        Feedback_batch &batch,
+                        EcanVci::Can_backend_handle backend) {
+  return detail::DecodeFeedback<Model>(
+      msgs, len, batch,
+      [backend](const CAN_OBJ &msg) { return backend.Timestamp(msg); });
+}
+
+} // namespace Motor
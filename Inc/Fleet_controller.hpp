@@ -0,0 +1,157 @@
+/**
+ * @file Fleet_controller.hpp
+ * @author KalecKKK
+ * @brief 上位机多轴控制：整组电机的 PID、抗饱和与前馈一次算完
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 设定值、反馈、增益与积分按列存放（SoA），Compute 调用 Simd::Pid
+ * 一遍算完所有轴，Stage 把输出直接写入 Frame_batch：
+ *
+ *   Motor::Fleet_controller fleet;
+ *   fleet.Add(motor, {.pid = {20.0f, 5.0f, 0.5f}, .output_limit = 10.0f});
+ *   // 每周期
+ *   Motor::DecodeFeedback<Motor::Encos_standard>(msgs, count, feedback);
+ *   fleet.UpdateFeedback(feedback);
+ *   fleet.SetSetpoint(0, position, speed, feedforward);
+ *   fleet.Compute(0.0005f);
+ *   fleet.Stage(batch);
+ *   batch.Transmit(can_transport);
+ */
+
+#pragma once
+
+#include "Estimator_bank.hpp"
+#include "Feedback_batch.hpp"
+#include "Frame_batch.hpp"
+#include "Motor_control.hpp"
+#include <array>
+#include <memory>
+#include <optional>
+#include <stdint.h>
+#include <vector>
+
+namespace Motor {
+
+constexpr uint32_t FLEET_SIZE = 256;
+
+/**
+ * @brief 控制输出写入的命令
+ */
+enum Fleet_output : uint8_t {
+  OUTPUT_HYBRID_TORQUE = 0x00, // 力位混合帧，kp、kd 为 0，输出为力矩 N·m
+  OUTPUT_CURRENT = 0x01,       // 电流模式，单位与 ControlWithMode 相同
+  OUTPUT_TORQUE = 0x02,        // 力矩模式，单位与 ControlWithMode 相同
+};
+
+struct Axis_config {
+  PID_parameters pid;
+  // 输出限幅 ±output_limit
+  float output_limit;
+  // 抗饱和反算增益 1/s，为空时取 ki / kp
+  std::optional<float> kaw;
+  Fleet_output output = OUTPUT_HYBRID_TORQUE;
+};
+
+class Fleet_controller {
+public:
+  struct Axes {
+    alignas(32) float kp[FLEET_SIZE];
+    alignas(32) float ki[FLEET_SIZE];
+    alignas(32) float kd[FLEET_SIZE];
+    alignas(32) float kaw[FLEET_SIZE];
+    alignas(32) float output_min[FLEET_SIZE];
+    alignas(32) float output_max[FLEET_SIZE];
+
+    alignas(32) float position_setpoint[FLEET_SIZE]; // rad
+    alignas(32) float speed_setpoint[FLEET_SIZE];    // rad/s
+    alignas(32) float feedforward[FLEET_SIZE];       // 与输出同单位
+
+    alignas(32) float position[FLEET_SIZE]; // rad
+    alignas(32) float speed[FLEET_SIZE];    // rad/s
+
+    alignas(32) float integral[FLEET_SIZE];
+    alignas(32) float output[FLEET_SIZE];
+  };
+
+  static constexpr uint16_t NO_AXIS = 0xFFFF;
+
+protected:
+  std::unique_ptr<Axes> axes;
+  std::vector<const Motor_core *> motors;
+  std::vector<Fleet_output> outputs;
+  // 标准帧电机 ID 到轴下标
+  std::array<uint16_t, 2048> axis_of;
+
+public:
+  Fleet_controller();
+
+  /**
+   * @brief 加入一个轴，设定值初始为零
+   * @return uint32_t 轴下标，按加入顺序
+   * @note 轴数超过 FLEET_SIZE 或电机已加入时抛出 std::runtime_error
+   */
+  uint32_t Add(const Motor_core &motor, const Axis_config &config);
+
+  uint32_t Size() const { return static_cast<uint32_t>(motors.size()); }
+
+  /**
+   * @brief 按列访问，调用方可直接整列写入设定值
+   */
+  Axes &Data() { return *axes; }
+  const Axes &Data() const { return *axes; }
+
+  /**
+   * @brief 电机 ID 对应的轴下标，未加入时为 NO_AXIS
+   */
+  uint16_t Axis(uint16_t motor_id) const {
+    return motor_id < axis_of.size() ? axis_of[motor_id] : NO_AXIS;
+  }
+
+  void SetSetpoint(uint32_t axis, float position, float speed = 0.0f,
+                   float feedforward = 0.0f);
+
+  /**
+   * @brief 修改增益与限幅，不清除积分
+   */
+  void SetGains(uint32_t axis, const Axis_config &config);
+
+  /**
+   * @brief 清除所有轴的积分项
+   */
+  void Reset();
+
+  /**
+   * @brief 以一批解码后的反馈更新位置与速度
+   * @return uint32_t 属于本组的反馈数量
+   */
+  uint32_t UpdateFeedback(const Feedback_batch &batch);
+
+  /**
+   * @brief 从各电机的 motor_info 更新位置与速度
+   */
+  void UpdateFeedback();
+
+  /**
+   * @brief 以估计器外推的位置与估计速度更新，未加入估计器的轴不变
+   */
+  void UpdateFeedback(const Estimator_bank &estimator);
+
+  /**
+   * @brief 计算所有轴的输出
+   * @param dt 控制周期 s
+   */
+  void Compute(float dt);
+
+  /**
+   * @brief 把所有轴的输出写入批次
+   * @param ack_status 电流与力矩模式的应答类型，混合帧无此字段
+   * @return uint32_t 写入的帧数量，批次已满时少于 Size()
+   */
+  uint32_t Stage(Frame_batch &batch,
+                 Message_return_status ack_status = ACK_TYPE_1) const;
+};
+
+} // namespace Motor
@@ -0,0 +1,85 @@
+/**
+ * @file Frame_batch.hpp
+ * @author KalecKKK
+ * @brief 连续存放的一批待发送帧，供多电机批量发送
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 电机通过 Motor_control::Stage* 把命令写入批次。每个位置记住上次写入的
+ * 电机与帧类型，每周期按相同顺序写入时只修改变化的字段，
+ * 不清零也不拷贝模板，Transmit 直接把整段数组交给驱动。
+ */
+
+#pragma once
+
+#include "Can_backend.hpp"
+#include <stdint.h>
+#include <vector>
+
+namespace Motor {
+
+class Motor_core;
+
+class Frame_batch {
+protected:
+  std::vector<CAN_OBJ> frames;
+  std::vector<const Motor_core *> owners;
+  std::vector<uint8_t> types;
+  uint32_t size, reserved;
+
+  // Override 写入的位置，下次 Acquire 总是先用模板覆盖
+  static constexpr uint8_t TYPE_OVERRIDE = 0xFF;
+
+public:
+  /**
+   * @param capacity 最多容纳的帧数量
+   */
+  explicit Frame_batch(uint32_t capacity);
+
+  uint32_t Size() const { return size; }
+  uint32_t Capacity() const { return static_cast<uint32_t>(frames.size()); }
+  CAN_OBJ *Data() { return frames.data(); }
+  const CAN_OBJ *Data() const { return frames.data(); }
+  const Motor_core *Owner(uint32_t index) const { return owners[index]; }
+
+  /**
+   * @brief 开始新的一批，保留各位置的内容以便下次原地修改
+   */
+  void Clear() { size = 0; }
+
+  /**
+   * @brief 取下一个位置
+   * 该位置上次由同一电机以同一类型写入时原样返回，否则先用模板覆盖
+   * @param owner 写入的电机
+   * @param type 帧类型
+   * @param frame_template 帧模板
+   * @return CAN_OBJ* 批次已满返回 nullptr
+   */
+  CAN_OBJ *Acquire(const Motor_core *owner, uint8_t type,
+                   const CAN_OBJ &frame_template);
+
+  /**
+   * @brief 保留末尾的位置给 Override，Acquire 不使用，保留值在 Clear 后仍有效
+   * @param count 保留的帧数量，不超过容量
+   */
+  void Reserve(uint32_t count);
+
+  /**
+   * @brief 以 frame 替换该电机在本批次中的命令
+   * 替换第一帧并删去其余各帧，没有时使用保留位置追加
+   * @param owner 电机
+   * @param frame 已编码的帧
+   * @return CAN_OBJ* 批次中的帧，保留位置也已用完时返回 nullptr
+   */
+  CAN_OBJ *Override(const Motor_core *owner, const CAN_OBJ &frame);
+
+  /**
+   * @brief 发送本批次的全部帧，实际发出的帧记入各电机的遥测命令历史
+   * @return DWORD 实际发送的帧数量
+   */
+  DWORD Transmit(EcanVci::Can_backend_handle can_transport);
+};
+
+} // namespace Motor
@@ -0,0 +1,93 @@
+/**
+ * @file Half_float.hpp
+ * @author KalecKKK
+ * @brief 线程安全的半精度浮点转换，支持 F16C 批量转换
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * FromFloat/ToFloat 为 IEEE 754 binary16，就近舍入到偶数，与 F16C 指令逐位一致，
+ * 包括非规格化数、无穷与 NaN。CPU 不支持 F16C 或 Simd 被限制在 AVX2 以下时
+ * 批量接口使用标量实现，结果相同。
+ *
+ * FromFloatEncos 与例程 math_ops.c 中的 float32_to_float16 逐位一致
+ * （截断、不处理非规格化数与溢出），仅用于与按该例程编码的固件互通。
+ * ToFloatEncos 是它的逆变换；例程的 float16_to_float32 丢失尾数第 2 位
+ * 并把最低两位错移一位，这里不沿用。
+ */
+
+#pragma once
+
+#include <bit>
+#include <stdint.h>
+
+namespace Half {
+
+constexpr uint16_t FromFloat(float value) {
+  constexpr uint32_t F32_INFINITY = 0xFFu << 23;
+  constexpr uint32_t F16_MAX = (127u + 16) << 23; // 2^16，不小于该值溢出为无穷
+  constexpr uint32_t DENORMAL_MAGIC = ((127u - 15) + (23 - 10) + 1) << 23;
+
+  uint32_t x = std::bit_cast<uint32_t>(value);
+  uint32_t sign = x & 0x80000000u;
+  x ^= sign;
+
+  uint32_t half;
+  if (x >= F16_MAX) {
+    // NaN 置静默位并保留高位载荷，与 F16C 一致
+    half = x > F32_INFINITY ? 0x7E00 | ((x >> 13) & 0x03FF) : 0x7C00;
+  } else if (x < (113u << 23)) {
+    // 结果为非规格化数或零，借助浮点加法完成就近舍入
+    float f = std::bit_cast<float>(x) + std::bit_cast<float>(DENORMAL_MAGIC);
+    half = std::bit_cast<uint32_t>(f) - DENORMAL_MAGIC;
+  } else {
+    uint32_t odd = (x >> 13) & 1;
+    x += ((15u - 127) << 23) + 0x0FFF + odd;
+    half = x >> 13;
+  }
+  return static_cast<uint16_t>(half | sign >> 16);
+}
+
+constexpr float ToFloat(uint16_t half) {
+  uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+  uint32_t magnitude = half & 0x7FFF;
+  if (magnitude >= 0x7C00) {
+    // 无穷与 NaN，NaN 置静默位
+    uint32_t mantissa = (magnitude & 0x03FF) << 13;
+    return std::bit_cast<float>(sign | 0x7F800000u | mantissa |
+                                (mantissa ? 0x00400000u : 0));
+  }
+  if (magnitude >= 0x0400) {
+    return std::bit_cast<float>(sign | ((magnitude << 13) + (112u << 23)));
+  }
+  // 非规格化数 magnitude * 2^-24，乘法精确
+  float f = static_cast<float>(magnitude) * 5.9604644775390625e-8f;
+  return std::bit_cast<float>(sign | std::bit_cast<uint32_t>(f));
+}
+
+constexpr uint16_t FromFloatEncos(float value) {
+  uint32_t x = std::bit_cast<uint32_t>(value);
+  uint16_t exponent = static_cast<uint16_t>(((x >> 23) & 0xFF) - 112);
+  uint16_t half = static_cast<uint16_t>(exponent << 10 | ((x >> 13) & 0x03FF));
+  return static_cast<uint16_t>(half | (x & 0x80000000u) >> 16);
+}
+
+constexpr float ToFloatEncos(uint16_t half) {
+  uint32_t exponent = ((half & 0x7C00u) >> 10) + 112;
+  return std::bit_cast<float>(exponent << 23 | (half & 0x03FFu) << 13 |
+                              (half & 0x8000u) << 16);
+}
+
+/**
+ * @brief 批量转换，可在多个线程中同时调用
+ */
+void FromFloat(const float values[], uint16_t halves[], uint32_t len);
+void ToFloat(const uint16_t halves[], float values[], uint32_t len);
+
+/**
+ * @brief 批量转换是否使用 F16C
+ */
+bool UsingF16c();
+
+} // namespace Half
@@ -0,0 +1,206 @@
+/**
+ * @file Logger.hpp
+ * @author KalecKKK
+ * @brief 异步低开销日志
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 调用线程只把 (调用点, 参数) 写入本线程的无锁环形缓冲区，
+ * 格式化与输出在后台线程完成。每个调用点可设置最小输出间隔，
+ * 间隔内的重复日志只计数，在下一条输出时附带被抑制的条数。
+ *
+ * 格式串用 {} 作占位符，{:x} 按十六进制输出整数。
+ * 字符串参数复制进记录，一条记录中的字符串总长超过 MAX_TEXT 时截断。
+ *
+ * 后台线程在进程退出（atexit）时停止并输出剩余记录，之后的日志
+ * （静态析构、仍在运行的线程）在调用线程中直接输出。
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <ctime>
+#include <stdint.h>
+#include <type_traits>
+
+namespace Log {
+
+enum Level : uint8_t {
+  DEBUG = 0x00,
+  INFO = 0x01,
+  WARN = 0x02,
+  ERROR = 0x03,
+};
+
+/**
+ * @brief 日志调用点，由宏生成静态实例，其地址即格式 ID
+ */
+struct Site {
+  const char *format;
+  Level level;
+  uint64_t min_interval_ns;
+  std::atomic<uint64_t> next_allowed;
+  std::atomic<uint32_t> suppressed;
+
+  constexpr Site(const char *format, Level level, uint32_t min_interval_ms)
+      : format(format), level(level),
+        min_interval_ns(static_cast<uint64_t>(min_interval_ms) * 1000000ULL),
+        next_allowed(0), suppressed(0) {}
+};
+
+enum Arg_type : uint8_t {
+  ARG_INT = 0x00,
+  ARG_UINT = 0x01,
+  ARG_DOUBLE = 0x02,
+  ARG_STRING = 0x03,
+  ARG_POINTER = 0x04,
+};
+
+constexpr int MAX_ARGS = 6;
+constexpr int MAX_TEXT = 96; // 一条记录中字符串参数的总字节数，含结尾 0
+
+/**
+ * @brief 二进制日志记录
+ */
+struct Record {
+  const Site *site;
+  uint64_t timestamp;
+  uint32_t suppressed;
+  uint8_t arg_count;
+  uint8_t arg_types[MAX_ARGS];
+  uint8_t text_used;
+  union {
+    int64_t i;
+    uint64_t u; // ARG_STRING 时为字符串在 text 中的偏移
+    double d;
+    const void *p;
+  } args[MAX_ARGS];
+  char text[MAX_TEXT];
+};
+
+inline uint64_t Now() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * @brief 取得本线程的记录槽，缓冲区满时返回 nullptr
+ */
+Record *Acquire();
+
+/**
+ * @brief 提交 Acquire 得到的记录
+ */
+void Commit();
+
+/**
+ * @brief 设置输出的最低级别
+ */
+void SetLevel(Level level);
+
+/**
+ * @brief 当前输出的最低级别
+ */
+Level GetLevel();
+
+/**
+ * @brief 阻塞直到此前提交的日志全部输出
+ */
+void Flush();
+
+/**
+ * @brief 因缓冲区满而丢弃的日志条数
+ */
+uint64_t DroppedCount();
+
+template <typename T> inline void Encode(Record &record, int index, T value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    record.arg_types[index] = ARG_UINT;
+    record.args[index].u = value;
+  } else if constexpr (std::is_enum_v<T>) {
+    record.arg_types[index] = ARG_INT;
+    record.args[index].i = static_cast<int64_t>(value);
+  } else if constexpr (std::is_floating_point_v<T>) {
+    record.arg_types[index] = ARG_DOUBLE;
+    record.args[index].d = value;
+  } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    record.arg_types[index] = ARG_INT;
+    record.args[index].i = value;
+  } else if constexpr (std::is_integral_v<T>) {
+    record.arg_types[index] = ARG_UINT;
+    record.args[index].u = value;
+  } else if constexpr (std::is_convertible_v<T, const char *>) {
+    // 复制字符串，调用返回后原字符串可以释放
+    const char *text = static_cast<const char *>(value);
+    if (!text) {
+      text = "(null)";
+    }
+    size_t room = MAX_TEXT - record.text_used;
+    size_t length = room ? strnlen(text, room - 1) : 0;
+    record.arg_types[index] = ARG_STRING;
+    record.args[index].u = record.text_used;
+    if (room) {
+      memcpy(record.text + record.text_used, text, length);
+      record.text[record.text_used + length] = '\0';
+      record.text_used = static_cast<uint8_t>(record.text_used + length + 1);
+    }
+  } else {
+    static_assert(std::is_pointer_v<T>, "Unsupported log argument type");
+    record.arg_types[index] = ARG_POINTER;
+    record.args[index].p = value;
+  }
+}
+
+template <typename... Args> inline void Write(Site &site, Args... args) {
+  static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+  if (site.level < GetLevel()) {
+    return;
+  }
+
+  uint64_t now = Now();
+  if (site.min_interval_ns) {
+    if (now < site.next_allowed.load(std::memory_order_relaxed)) {
+      site.suppressed.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    site.next_allowed.store(now + site.min_interval_ns,
+                            std::memory_order_relaxed);
+  }
+
+  Record *record = Acquire();
+  if (!record) {
+    return;
+  }
+  record->site = &site;
+  record->timestamp = now;
+  record->suppressed =
+      site.min_interval_ns
+          ? site.suppressed.exchange(0, std::memory_order_relaxed)
+          : 0;
+  record->arg_count = sizeof...(Args);
+  record->text_used = 0;
+  int index = 0;
+  (Encode(*record, index++, args), ...);
+  Commit();
+}
+
+} // namespace Log
+
+#define LOG_EVERY(level, interval_ms, format, ...)                             \
+  do {                                                                         \
+    static ::Log::Site log_site_(format, level, interval_ms);                  \
+    ::Log::Write(log_site_ __VA_OPT__(, ) __VA_ARGS__);                        \
+  } while (0)
+
+#define LOG_DEBUG(format, ...)                                                 \
+  LOG_EVERY(::Log::DEBUG, 0, format __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_INFO(format, ...)                                                  \
+  LOG_EVERY(::Log::INFO, 0, format __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_WARN(format, ...)                                                  \
+  LOG_EVERY(::Log::WARN, 0, format __VA_OPT__(, ) __VA_ARGS__)
+#define LOG_ERROR(format, ...)                                                 \
+  LOG_EVERY(::Log::ERROR, 0, format __VA_OPT__(, ) __VA_ARGS__)
@@ -0,0 +1,373 @@
+/**
+ * @file Motor_async.hpp
+ * @author KalecKKK
+ * @brief 基于 C++20 协程的电机命令异步接口与单线程执行器
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 执行器与一个收发后端（Can_backend）的接收循环绑定，在同一线程内驱动所有协程：
+ * 命令发出后协程挂起，收到匹配的应答或超时重发耗尽后恢复。
+ *
+ *   Motor::Async_executor executor(can_transport);
+ *   executor.Attach(motor);
+ *   executor.Spawn([&]() -> Motor::Task<> {
+ *     co_await motor.SetZeroAsync();
+ *     auto mode = co_await motor.QueryCommunicationModeAsync();
+ *   }());
+ *   executor.Run();
+ */
+
+#pragma once
+
+#include "Can_backend.hpp"
+#include "Dispatch_table.hpp"
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Motor {
+
+class Motor_core;
+class Async_executor;
+
+/**
+ * @brief 惰性启动的协程任务，可被 co_await 或交给执行器运行
+ */
+template <typename T = void> class Task;
+
+namespace detail {
+
+struct Promise_base {
+  std::coroutine_handle<> continuation;
+  std::exception_ptr exception;
+
+  struct Final_awaiter {
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<>
+    await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+      auto continuation = handle.promise().continuation;
+      return continuation ? continuation : std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+  };
+
+  std::suspend_always initial_suspend() const noexcept { return {}; }
+  Final_awaiter final_suspend() const noexcept { return {}; }
+  void unhandled_exception() { exception = std::current_exception(); }
+};
+
+template <typename T> struct Promise : Promise_base {
+  T value{};
+  Task<T> get_return_object();
+  void return_value(T v) { value = std::move(v); }
+  T Result() {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+    return std::move(value);
+  }
+};
+
+template <> struct Promise<void> : Promise_base {
+  Task<void> get_return_object();
+  void return_void() {}
+  void Result() {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+};
+
+} // namespace detail
+
+template <typename T> class Task {
+public:
+  using promise_type = detail::Promise<T>;
+
+protected:
+  std::coroutine_handle<promise_type> handle;
+
+  friend class Async_executor;
+
+public:
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+  Task(Task &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  ~Task() {
+    if (handle) {
+      handle.destroy();
+    }
+  }
+
+  bool await_ready() const noexcept { return false; }
+  std::coroutine_handle<>
+  await_suspend(std::coroutine_handle<> continuation) noexcept {
+    handle.promise().continuation = continuation;
+    return handle;
+  }
+  T await_resume() { return handle.promise().Result(); }
+};
+
+template <typename T> Task<T> detail::Promise<T>::get_return_object() {
+  return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> detail::Promise<void>::get_return_object() {
+  return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+enum Reply_kind : uint8_t {
+  REPLY_NONE = 0x00,       // 不等待应答
+  REPLY_ACK = 0x01,        // 电机 ID 上的应答帧，按 ACK 类型匹配
+  REPLY_MANAGEMENT = 0x02, // 0x7FF 上的反馈帧，按帧内电机 ID 匹配
+};
+
+// 0x7FF 反馈帧中代替电机 ID 的特殊值，见例程 can_rv.c
+constexpr uint16_t MANAGEMENT_ID_QUERY = 0xFFFF;  // ID 查询成功，反馈码 0x01
+constexpr uint16_t MANAGEMENT_RESET_ID = 0x7F7F;  // 重置 ID 成功，反馈码 0x05
+constexpr uint16_t MANAGEMENT_QUERY_FAILED = 0x8080; // 查询失败，反馈码 0x80
+
+struct Reply_match {
+  Reply_kind kind;
+  uint8_t ack_type;
+  uint16_t management_id;
+  UINT id;
+  uint8_t instruction = 0; // 应答帧 4、5 的指令码，0 表示不检查
+
+  /**
+   * @brief 关联键，应答帧与等待它的请求键相同
+   */
+  uint64_t Key() const {
+    return kind == REPLY_ACK ? id : 1ULL << 32 | management_id;
+  }
+
+  /**
+   * @brief 接收帧的关联键，非管理反馈的 0x7FF 帧返回其 ID 本身，不会匹配任何请求
+   *
+   * 查询失败的反馈交给等待 ID 查询结果的请求，使其立即结束而不是等到超时。
+   */
+  static uint64_t Key(const CAN_OBJ &msg) {
+    if (msg.ID == 0x7FF && msg.DataLen >= 4 && msg.Data[2] == 0x01) {
+      uint16_t management_id = ManagementID(msg);
+      return 1ULL << 32 | (management_id == MANAGEMENT_QUERY_FAILED
+                               ? MANAGEMENT_ID_QUERY
+                               : management_id);
+    }
+    return msg.ID;
+  }
+
+  static uint16_t ManagementID(const CAN_OBJ &msg) {
+    return static_cast<uint16_t>(msg.Data[0] << 8 | msg.Data[1]);
+  }
+
+  bool Matches(const CAN_OBJ &msg) const {
+    if (kind == REPLY_ACK) {
+      return msg.ID == id && msg.DataLen > 0 &&
+             ((msg.Data[0] >> 5) & 0b111) == ack_type &&
+             (instruction == 0 ||
+              (msg.DataLen >= 2 && msg.Data[1] == instruction));
+    }
+    if (msg.ID != 0x7FF || msg.DataLen < 4 || msg.Data[2] != 0x01) {
+      return false;
+    }
+    return ManagementID(msg) == management_id ||
+           (management_id == MANAGEMENT_ID_QUERY &&
+            ManagementID(msg) == MANAGEMENT_QUERY_FAILED);
+  }
+};
+
+/**
+ * @brief 等待应答的请求，由执行器挂在等待队列上
+ */
+struct Reply_waiter {
+  CAN_OBJ request;
+  CAN_OBJ reply;
+  Reply_match match;
+  DWORD status;
+  uint16_t retries_left;
+  std::chrono::steady_clock::time_point deadline;
+  std::coroutine_handle<> handle;
+  const Motor_core *owner; // 每次发出后记入其遥测命令历史，可为 nullptr
+};
+
+/**
+ * @brief 命令的 awaitable，co_await 的结果由 decode 从应答帧得到
+ */
+template <typename T> class Reply_awaiter : protected Reply_waiter {
+protected:
+  Async_executor *executor;
+  T (*decode)(DWORD status, const CAN_OBJ &reply);
+
+public:
+  Reply_awaiter(Async_executor *executor, const Motor_core *owner,
+                const CAN_OBJ &request, Reply_match match, uint16_t retries,
+                T (*decode)(DWORD status, const CAN_OBJ &reply))
+      : Reply_waiter{request, {}, match, STATUS_ERR, retries, {}, {}, owner},
+        executor(executor), decode(decode) {}
+
+  bool await_ready() const noexcept { return false; }
+  inline bool await_suspend(std::coroutine_handle<> handle);
+  T await_resume() const { return decode(status, reply); }
+};
+
+/**
+ * @brief 单线程协程执行器
+ */
+class Async_executor {
+protected:
+  struct Detached {
+    struct promise_type {
+      Detached get_return_object() {
+        return {std::coroutine_handle<promise_type>::from_promise(*this)};
+      }
+      std::suspend_always initial_suspend() const noexcept { return {}; }
+      std::suspend_never final_suspend() const noexcept { return {}; }
+      void return_void() const noexcept {}
+      void unhandled_exception() const noexcept { std::terminate(); }
+    };
+    std::coroutine_handle<promise_type> handle;
+  };
+
+  struct Timer_awaiter {
+    Async_executor &executor;
+    std::chrono::steady_clock::time_point deadline;
+
+    bool await_ready() const noexcept {
+      return std::chrono::steady_clock::now() >= deadline;
+    }
+    void await_suspend(std::coroutine_handle<> handle) {
+      executor.timers.emplace(deadline, handle);
+    }
+    void await_resume() const noexcept {}
+  };
+
+  EcanVci::Can_backend_handle can_transport;
+
+  Dispatch_table dispatch_table;
+  std::deque<std::coroutine_handle<>> ready;
+  // 按关联键分组，同一键内按发出顺序排队
+  std::unordered_map<uint64_t, std::deque<Reply_waiter *>> waiters;
+  size_t waiter_count;
+
+  // 应答超时的最小堆，应答到达时不删除，出堆时按关联键与 deadline 识别过期项
+  struct Deadline {
+    std::chrono::steady_clock::time_point deadline;
+    uint64_t key;
+    Reply_waiter *waiter;
+
+    bool operator>(const Deadline &other) const {
+      return deadline > other.deadline;
+    }
+  };
+  mutable std::priority_queue<Deadline, std::vector<Deadline>,
+                              std::greater<Deadline>>
+      deadlines;
+  std::multimap<std::chrono::steady_clock::time_point, std::coroutine_handle<>>
+      timers;
+
+  size_t live_tasks;
+  std::exception_ptr failure;
+
+  std::chrono::microseconds reply_timeout;
+
+  CAN_OBJ receive_buffer[100];
+
+  Detached Drive(Task<void> task);
+
+  // 后端支持接收过滤时只接收已登记电机的帧
+  void UpdateFilter();
+
+  // 堆项对应的请求仍在等待且未被重发刷新 deadline
+  bool Armed(const Deadline &entry) const;
+
+  void Dispatch(const CAN_OBJ &msg);
+  void Expire(std::chrono::steady_clock::time_point now);
+  void ResumeReady();
+
+  template <typename T> friend class Reply_awaiter;
+
+  /**
+   * @brief 发出请求并登记等待
+   * @return bool 是否需要挂起
+   */
+  bool Submit(Reply_waiter &waiter, std::coroutine_handle<> handle);
+
+public:
+  explicit Async_executor(EcanVci::Can_backend_handle can_transport);
+
+  Async_executor(const Async_executor &) = delete;
+  Async_executor &operator=(const Async_executor &) = delete;
+
+  /**
+   * @brief 登记电机，收到的反馈帧会更新其 motor_info，其异步命令由本执行器驱动
+   * 后端支持接收过滤（如 SocketCAN）时，过滤随登记的电机更新
+   * @return DWORD 电机ID与已登记的电机冲突时返回 STATUS_ERR
+   */
+  DWORD Attach(Motor_core &motor);
+
+  /**
+   * @brief 注销电机，之后其异步命令不再由本执行器驱动
+   */
+  void Detach(Motor_core &motor);
+
+  /**
+   * @brief 设置单次等待应答的超时时间，超时后按电机的最大重试次数重发
+   */
+  void SetReplyTimeout(std::chrono::microseconds timeout);
+
+  /**
+   * @brief 交给执行器运行一个任务
+   */
+  void Spawn(Task<void> task);
+
+  /**
+   * @brief 挂起当前协程一段时间
+   */
+  Timer_awaiter Delay(std::chrono::steady_clock::duration duration) {
+    return {*this, std::chrono::steady_clock::now() + duration};
+  }
+
+  /**
+   * @brief 执行一轮：恢复就绪协程、接收并分发帧、处理超时
+   * @param wait_time 没有就绪协程时接收的最长等待时间 ms
+   */
+  void Poll(INT wait_time = 1);
+
+  /**
+   * @brief 最早的应答超时或定时器到期时间，供事件循环设置定时器
+   * @return std::chrono::steady_clock::time_point 没有等待时为 time_point::max()
+   */
+  std::chrono::steady_clock::time_point NextDeadline() const;
+
+  /**
+   * @brief 运行直到所有任务结束，任务中未捕获的异常在此重新抛出
+   */
+  void Run();
+
+  /**
+   * @brief 尚未结束的任务数
+   */
+  size_t LiveTasks() const { return live_tasks; }
+};
+
+template <typename T>
+bool Reply_awaiter<T>::await_suspend(std::coroutine_handle<> handle) {
+  if (!executor) {
+    status = STATUS_ERR;
+    return false;
+  }
+  return executor->Submit(*this, handle);
+}
+
+} // namespace Motor
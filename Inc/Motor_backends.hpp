@@ -0,0 +1,30 @@
+/**
+ * @file Motor_backends.hpp
+ * @author KalecKKK
+ * @brief 声明 Motor_control.cpp 中为其他收发后端显式实例化的电机类型
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Motor_control.hpp 只声明 Can_transport 与 Can_backend_handle 的实例化，
+ * 以 motord、SocketCAN 或接收引擎为后端时包含本文件，避免重复实例化。
+ *
+ *   EcanVci::Socket_can_transport can0("can0");
+ *   Motor::Basic_motor_control<EcanVci::Socket_can_transport> motor(can0, 1);
+ */
+
+#pragma once
+
+#include "Motor_control.hpp"
+#include "Motord.hpp"
+#include "Receive_engine.hpp"
+#include "Socket_can_transport.hpp"
+
+namespace Motor {
+
+extern template class Basic_motor_control<Motord::Motord_client>;
+extern template class Basic_motor_control<EcanVci::Socket_can_transport>;
+extern template class Basic_motor_control<EcanVci::Receive_engine>;
+
+} // namespace Motor
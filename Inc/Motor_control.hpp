@@ -12,6 +12,9 @@
 #pragma once
 
 #include "Can_transport.hpp"
+#include "Motor_async.hpp"
+#include "Motor_model.hpp"
+#include <optional>
 #include <stdint.h>
 
 namespace Motor {
@@ -21,17 +24,6 @@ enum Communication_mode {
   QA_MODE = 0x02,
 };
 
-enum ErrorCode {
-  NO_ERROR = 0x00,
-  OVERHEAT = 0x01,
-  OVERCURRENT = 0x02,
-  LOW_VOLTAGE = 0x03,
-  ENCODER_ERROR = 0x04,
-  INDICATES_ERROR = 0x05,
-  BREKE_HIGH_VOLTAGE = 0x06,
-  DRV_DRIVER_ERROR = 0x07,
-};
-
 struct PID_parameters {
   float kp, ki, kd;
 };
@@ -53,58 +45,229 @@ enum Message_return_status {
   ACK_TYPE_5 = 0x05,
 };
 
-class Motor_control {
+/**
+ * @brief 应答帧的数据长度，用于总线带宽预算
+ * @return uint8_t 无应答返回 0
+ */
+constexpr uint8_t ReplyLength(Message_return_status ack_status) {
+  switch (ack_status) {
+  case ACK_TYPE_1:
+  case ACK_TYPE_2:
+  case ACK_TYPE_3:
+    return 8;
+  case ACK_TYPE_4:
+    return 3;
+  case ACK_TYPE_5:
+    return 6;
+  default:
+    return 0;
+  }
+}
+
+// 命令帧的数据长度，与 Encode* 一致
+constexpr uint8_t POSITION_FRAME_LENGTH = 8;
+constexpr uint8_t SPEED_FRAME_LENGTH = 7;
+constexpr uint8_t CURRENT_FRAME_LENGTH = 3;
+constexpr uint8_t HYBRID_FRAME_LENGTH = 8;
+
+/**
+ * @brief 预填充的控制帧模板类型，力矩与制动模式共用电流帧
+ */
+enum Frame_type : uint8_t {
+  FRAME_POSITION = 0x00,
+  FRAME_SPEED = 0x01,
+  FRAME_CURRENT = 0x02,
+  FRAME_HYBRID = 0x03,
+  FRAME_TYPE_COUNT,
+};
+
+/**
+ * @brief 参数查询指令码，1~4 为单精度浮点，5~9 为 16 位无符号整数
+ */
+enum Parameter_code : uint8_t {
+  PARAM_POSITION = 0x01,
+  PARAM_SPEED = 0x02,
+  PARAM_CURRENT = 0x03,
+  PARAM_POWER = 0x04,
+  PARAM_ACCELERATION = 0x05,
+  PARAM_LINKAGE_KP = 0x06,
+  PARAM_SPEED_KI = 0x07,
+  PARAM_FEEDBACK_KP = 0x08,
+  PARAM_FEEDBACK_KD = 0x09,
+};
+
+constexpr uint16_t ACCELERATION_MAX = 2000;
+constexpr uint16_t GAIN_MAX = 10000;
+
+/**
+ * @brief 由应答帧 5 得到的参数
+ */
+struct Motor_parameters {
+  float position;
+  float speed;
+  float current;
+  float power;
+  uint16_t acceleration;
+  uint16_t linkage_kp;
+  uint16_t speed_ki;
+  uint16_t feedback_kp;
+  uint16_t feedback_kd;
+};
+
+class Telemetry_publisher;
+class Frame_batch;
+class Fault_monitor;
+
+/**
+ * @brief 电机中与收发后端无关的部分：帧编码、反馈解析、批量与异步接口
+ */
+class Motor_core {
 protected:
   typedef uint8_t status_type;
 
-  const EcanVci::Can_transport &can_transport;
-
   uint8_t id_high, id_low;
 
   uint16_t max_retry_times;
 
+  Model_handle model;
+
+  Async_executor *executor;
+
+  const Telemetry_publisher *telemetry;
+  uint32_t telemetry_slot;
+
+  Fault_monitor *fault_monitor;
+  uint32_t fault_slot;
+
+  // 控制帧模板，ID、长度与固定位在构造与 ChangeID 时写好，之后只读，
+  // Encode*/Stage* 可在任意线程使用
+  CAN_OBJ templates[FRAME_TYPE_COUNT];
+  // 同步接口的发送帧，每次只原地修改设定值，只由调用同步接口的线程使用
+  mutable CAN_OBJ frames[FRAME_TYPE_COUNT];
+
+  void InitFrames();
+
   /**
-   * @brief 发送命令
-   * @return status_type 返回状态类型
+   * @brief 电机改用新 ID 后同步本对象：重建帧模板，并在已绑定的执行器中重新登记
+   * 不得与其他线程中的 Encode、Stage 接口并发调用
    */
-  status_type SendCmd();
+  void ChangeID(uint16_t id);
 
-  Motor_control() = delete;
-  Motor_control(Motor_control &) = delete;
-  Motor_control &operator=(Motor_control &) = delete;
+  friend class Async_executor;
+  friend class Watchdog;
 
-public:
-  struct Motor_info {
-    uint16_t motor_id;
-    ErrorCode error_code;
-    float position;
-    float speed;
-    float current;
-    uint8_t motor_temperature;
-    uint8_t MOS_temperature;
-  } motor_info;
+  /**
+   * @brief 在模板上原地写入设定值，只修改变化的字节
+   */
+  static void PatchPosition(CAN_OBJ &msg, float position, uint16_t speed,
+                            uint16_t current, Message_return_status ack_status);
+  static void PatchSpeed(CAN_OBJ &msg, float speed, uint16_t current,
+                         Message_return_status ack_status);
+  static void PatchCurrent(CAN_OBJ &msg, uint16_t current,
+                           Message_return_status ack_status);
+  static void PatchControlWithMode(CAN_OBJ &msg, Control_mode control_mode,
+                                   float current_or_torque,
+                                   Message_return_status ack_status);
 
-  DWORD UpdateInfo();
+  /**
+   * @brief 编码命令帧，同步与异步接口共用
+   */
+  void EncodeSetting(CAN_OBJ &msg, uint8_t cmd) const;
+  void EncodeResetID(CAN_OBJ &msg, uint16_t new_id) const;
+  static void EncodeResetIDBroadcast(CAN_OBJ &msg);
+  static void EncodeQueryID(CAN_OBJ &msg);
+  void EncodePosition(CAN_OBJ &msg, float position, uint16_t speed,
+                      uint16_t current, Message_return_status ack_status) const;
+  void EncodeSpeed(CAN_OBJ &msg, float speed, uint16_t current,
+                   Message_return_status ack_status) const;
+  void EncodeCurrent(CAN_OBJ &msg, uint16_t current,
+                     Message_return_status ack_status) const;
+  void EncodeControlWithMode(CAN_OBJ &msg, Control_mode control_mode,
+                             float current_or_torque,
+                             Message_return_status ack_status) const;
+  void EncodeParameter(CAN_OBJ &msg, uint8_t code, uint16_t first,
+                       uint16_t second, Message_return_status ack_status) const;
+  void EncodeGetParameter(CAN_OBJ &msg, Parameter_code code) const;
+
+  /**
+   * @brief 构造等待应答帧的 awaitable
+   */
+  Reply_awaiter<DWORD> AwaitReply(const CAN_OBJ &msg, Reply_match match) const;
+  Reply_awaiter<DWORD> AwaitAck(const CAN_OBJ &msg,
+                                Message_return_status ack_status) const;
+
+  /**
+   * @brief 不发送、直接以 STATUS_ERR 完成的 awaitable，用于参数不合法的请求
+   */
+  static Reply_awaiter<DWORD> RejectReply();
 
-public:
   /**
    * @brief 构造函数
    * @param id_high 高位ID
    * @param id_low 低位ID
+   * @param model 电机型号
    */
-  Motor_control(const EcanVci::Can_transport &can_transport, uint8_t id_high,
-                uint8_t id_low);
+  Motor_core(uint8_t id_high, uint8_t id_low, Model_handle model);
 
   /**
    * @brief 构造函数
    * @param id 电机ID
+   * @param model 电机型号
+   */
+  Motor_core(uint16_t id, Model_handle model);
+
+  ~Motor_core();
+
+  Motor_core() = delete;
+  Motor_core(Motor_core &) = delete;
+  Motor_core &operator=(Motor_core &) = delete;
+
+public:
+  typedef Motor::Motor_info Motor_info;
+
+  Motor_info motor_info;
+
+  Motor_parameters motor_parameters;
+
+  /**
+   * @brief 解析应答帧 5
+   * @param msg 应答帧
+   * @param code 输出参数指令码
+   * @return std::optional<float> 不是应答帧 5 或长度不符时为空
+   */
+  static std::optional<float> DecodeParameter(const CAN_OBJ &msg,
+                                              Parameter_code &code);
+
+  /**
+   * @brief 解析一帧反馈，更新 motor_info
+   * @param msg 接收到的帧
+   * @return DWORD 不是本电机的帧或无法解析返回 STATUS_ERR
+   */
+  DWORD ProcessFrame(const CAN_OBJ &msg);
+
+  /**
+   * @brief 电机ID
+   */
+  uint16_t ID() const { return static_cast<uint16_t>(id_high << 8 | id_low); }
+
+  /**
+   * @brief 电机型号
+   */
+  const Model_handle &Model() const { return model; }
+
+  /**
+   * @brief 挂载遥测发布，状态更新与发出的命令写入共享内存
+   * @param telemetry 遥测写端，nullptr 表示关闭
+   * @param slot 本电机使用的槽
    */
-  Motor_control(const EcanVci::Can_transport &can_transport, uint16_t id);
+  void AttachTelemetry(const Telemetry_publisher *telemetry, uint32_t slot);
 
   /**
-   * @brief 析构函数
+   * @brief 挂载故障监视，解析应答帧 1~3 后报告错误码，由 Fault_monitor::Add 调用
+   * @param fault_monitor 故障监视，nullptr 表示关闭
+   * @param slot 本电机使用的槽
    */
-  ~Motor_control();
+  void AttachFaultMonitor(Fault_monitor *fault_monitor, uint32_t slot);
 
   /**
    * @brief 设置最大重试次数
@@ -112,6 +275,180 @@ public:
    */
   void SetMaxRetryTimes(uint16_t max_retry_times);
 
+  /**
+   * @brief 把发出的命令记入遥测命令历史
+   * 同步接口、执行器（含重发）与 Frame_batch::Transmit 在发送成功后调用
+   */
+  void Track(const CAN_OBJ &msg) const;
+
+  /**
+   * 以下 Stage 接口把命令写入批次而不立即发送，
+   * 所有电机写完后由 Frame_batch::Transmit 一次发出，发出时才记入遥测。
+   * 只读帧模板，可在同步接口之外的线程调用。
+   * @return CAN_OBJ* 批次中的帧，批次已满或应答类型不支持时返回 nullptr
+   */
+
+  CAN_OBJ *StagePosition(Frame_batch &batch, float position, uint16_t speed,
+                         uint16_t current,
+                         Message_return_status ack_status) const;
+  CAN_OBJ *StageSpeed(Frame_batch &batch, float speed, uint16_t current,
+                      Message_return_status ack_status) const;
+  CAN_OBJ *StageCurrent(Frame_batch &batch, uint16_t current,
+                        Message_return_status ack_status) const;
+  CAN_OBJ *StageControlWithMode(Frame_batch &batch, Control_mode control_mode,
+                                float current_or_torque,
+                                Message_return_status ack_status) const;
+  CAN_OBJ *StageHybrid(Frame_batch &batch, float kp, float kd, float position,
+                       float speed, float torque) const;
+
+  /**
+   * 以下异步接口需先通过 Async_executor::Attach 绑定执行器，
+   * co_await 的结果为 STATUS_OK 或超时重试耗尽后的 STATUS_ERR。
+   * ack_status 为 NO_ACK 时发出即返回。
+   */
+
+  /**
+   * @brief 设为零位并等待反馈
+   */
+  Reply_awaiter<DWORD> SetZeroAsync() const;
+
+  /**
+   * @brief 重置ID并等待反馈，成功后本对象改用新ID
+   * @param new_id 新ID
+   */
+  Task<DWORD> ResetIDAsync(uint16_t new_id);
+
+  /**
+   * @brief 广播恢复出厂 ID 1 并等待重置成功的反馈，总线上只能有一个电机
+   * 本对象的 ID 不变，之后用 AssignIDAsync 改回
+   */
+  Reply_awaiter<DWORD> ResetIDAsync() const;
+
+  /**
+   * @brief 把当前以 current_id 应答的电机改为本对象的 ID 并等待反馈
+   * @param current_id 电机当前的 ID
+   */
+  Reply_awaiter<DWORD> AssignIDAsync(uint16_t current_id) const;
+
+  /**
+   * @brief 广播查询 ID，总线上只能有一个电机
+   * @return std::optional<uint16_t> 查询失败或超时为空
+   */
+  Reply_awaiter<std::optional<uint16_t>> QueryIDAsync() const;
+
+  /**
+   * @brief 设置通信模式并等待反馈
+   * @param mode 通信模式
+   */
+  Reply_awaiter<DWORD> SetCommunicationModeAsync(Communication_mode mode) const;
+
+  /**
+   * @brief 查询通信模式
+   * @return Communication_mode 超时返回 UNKOWN
+   */
+  Reply_awaiter<Communication_mode> QueryCommunicationModeAsync() const;
+
+  /**
+   * @brief 设置位置并等待应答
+   */
+  Reply_awaiter<DWORD>
+  SetPositionAsync(float position, uint16_t speed, uint16_t current,
+                   Message_return_status ack_status = ACK_TYPE_1) const;
+
+  /**
+   * @brief 设置速度并等待应答
+   */
+  Reply_awaiter<DWORD>
+  SetSpeedAsync(float speed, uint16_t current,
+                Message_return_status ack_status = ACK_TYPE_1) const;
+
+  /**
+   * @brief 设置电流并等待应答
+   */
+  Reply_awaiter<DWORD>
+  SetCurrentAsync(uint16_t current,
+                  Message_return_status ack_status = ACK_TYPE_1) const;
+
+  /**
+   * @brief 以指定模式控制并等待应答
+   */
+  Reply_awaiter<DWORD>
+  ControlWithModeAsync(Control_mode control_mode, float current_or_torque,
+                       Message_return_status ack_status = ACK_TYPE_1) const;
+
+  /**
+   * @brief 设置加速度并等待应答，ack_status 为 NO_ACK 时发出即返回
+   * @note 应答类型只支持 0~2，其他类型不发送，结果为 STATUS_ERR
+   */
+  Reply_awaiter<DWORD>
+  SetAccelerationAsync(uint16_t acceleration,
+                       Message_return_status ack_status = ACK_TYPE_1) const;
+
+  /**
+   * @brief 设置联动系数与速度环积分并等待应答
+   * @note 应答类型只支持 0~2，其他类型不发送，结果为 STATUS_ERR
+   */
+  Reply_awaiter<DWORD>
+  SetLinkageSpeedKIAsync(uint16_t linkage_kp, uint16_t speed_ki,
+                         Message_return_status ack_status = ACK_TYPE_1) const;
+
+  /**
+   * @brief 设置反馈 KP 与 KD 并等待应答
+   * @note 应答类型只支持 0~2，其他类型不发送，结果为 STATUS_ERR
+   */
+  Reply_awaiter<DWORD>
+  SetFeedbackKPKDAsync(uint16_t feedback_kp, uint16_t feedback_kd,
+                       Message_return_status ack_status = ACK_TYPE_1) const;
+
+  /**
+   * @brief 查询参数
+   * @return std::optional<float> 超时为空
+   */
+  Reply_awaiter<std::optional<float>>
+  GetParameterAsync(Parameter_code code) const;
+};
+
+/**
+ * @brief 绑定到具体收发后端的电机，同步接口直接调用后端，无虚函数开销
+ * @tparam Backend 满足 EcanVci::Can_backend 的收发后端
+ */
+template <EcanVci::Can_backend Backend>
+class Basic_motor_control : public Motor_core {
+protected:
+  const Backend &can_transport;
+
+  /**
+   * @brief 发送命令
+   * @param msg 命令帧
+   * @return status_type 返回状态类型
+   */
+  status_type SendCmd(CAN_OBJ &msg) const;
+
+public:
+  /**
+   * @brief 构造函数
+   * @param id_high 高位ID
+   * @param id_low 低位ID
+   * @param model 电机型号
+   */
+  Basic_motor_control(const Backend &can_transport, uint8_t id_high,
+                      uint8_t id_low,
+                      Model_handle model = Model_handle::Of<Encos_standard>());
+
+  /**
+   * @brief 构造函数
+   * @param id 电机ID
+   * @param model 电机型号
+   */
+  Basic_motor_control(const Backend &can_transport, uint16_t id,
+                      Model_handle model = Model_handle::Of<Encos_standard>());
+
+  /**
+   * @brief 接收并处理本电机的反馈帧
+   * @return DWORD 收到并解析了本电机的帧返回 STATUS_OK
+   */
+  DWORD UpdateInfo();
+
   /**
    * @brief 设为零位
    * @return status_type 返回状态类型
@@ -119,13 +456,13 @@ public:
   status_type SetZero() const;
 
   /**
-   * @brief 重置ID
+   * @brief 广播恢复出厂 ID 1，本对象的 ID 不变
    * @return status_type 返回状态类型
    */
   status_type ResetID();
 
   /**
-   * @brief 重置ID
+   * @brief 重置ID，发送成功后本对象改用新ID
    * @param new_id 新ID
    * @return status_type 返回状态类型
    */
@@ -139,6 +476,13 @@ public:
    */
   status_type ResetID(uint8_t new_id_high, uint8_t new_id_low);
 
+  /**
+   * @brief 设置通信模式
+   * @param mode 通信模式
+   * @return status_type 返回状态类型
+   */
+  status_type SetCommunicationMode(Communication_mode mode) const;
+
   /**
    * @brief 查询通信模式
    * @return Motor::Communication_mode 返回通信模式
@@ -155,7 +499,7 @@ public:
    * @brief 查询ID
    * @return uint16_t 返回ID
    */
-  static uint16_t QueryID(const EcanVci::Can_transport &can_transport);
+  static uint16_t QueryID(const Backend &can_transport);
 
   /**
    * @brief 混合控制
@@ -201,6 +545,44 @@ public:
    */
   void ControlWithMode(Control_mode control_mode, float current_or_torque,
                        Message_return_status ack_status) const;
+
+  /**
+   * @brief 设置加速度
+   * @param acceleration 0~2000
+   * @param ack_status 报文返回状态，只支持 0~2
+   */
+  void SetAcceleration(uint16_t acceleration,
+                       Message_return_status ack_status) const;
+
+  /**
+   * @brief 设置联动系数与速度环积分
+   * @param linkage_kp 0~10000
+   * @param speed_ki 0~10000
+   * @param ack_status 报文返回状态，只支持 0~2
+   */
+  void SetLinkageSpeedKI(uint16_t linkage_kp, uint16_t speed_ki,
+                         Message_return_status ack_status) const;
+
+  /**
+   * @brief 设置反馈 KP 与 KD
+   * @param feedback_kp 0~10000
+   * @param feedback_kd 0~10000
+   * @param ack_status 报文返回状态，只支持 0~2
+   */
+  void SetFeedbackKPKD(uint16_t feedback_kp, uint16_t feedback_kd,
+                       Message_return_status ack_status) const;
+
+  /**
+   * @brief 查询参数，结果由应答帧 5 写入 motor_parameters
+   * @param code 参数指令码
+   */
+  void GetParameter(Parameter_code code) const;
 };
 
+// 已知后端在 Motor_control.cpp 中显式实例化，其他后端的声明见 Motor_backends.hpp
+extern template class Basic_motor_control<EcanVci::Can_transport>;
+extern template class Basic_motor_control<EcanVci::Can_backend_handle>;
+
+typedef Basic_motor_control<EcanVci::Can_transport> Motor_control;
+
 } // namespace Motor
@@ -0,0 +1,204 @@
+/**
+ * @file Motor_model.hpp
+ * @author KalecKKK
+ * @brief 电机型号参数与编解码，量程与比例常量在编译期折叠
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 每个型号是一个只含 constexpr 量程的结构体，Codec<Model> 由量程在编译期
+ * 得到比例与偏移。同一型号的批量处理直接使用 Codec<Model>；混合型号的电机组
+ * 通过 Model_handle 调用，每帧多一次间接调用。
+ *
+ * 新增型号时按 Encos_standard 的成员定义一个结构体即可。
+ */
+
+#pragma once
+
+#include "ECanVci.h"
+#include <algorithm>
+#include <bit>
+#include <stdint.h>
+
+namespace Motor {
+
+enum ErrorCode {
+  NO_ERROR = 0x00,
+  OVERHEAT = 0x01,
+  OVERCURRENT = 0x02,
+  LOW_VOLTAGE = 0x03,
+  ENCODER_ERROR = 0x04,
+  INDICATES_ERROR = 0x05,
+  BREKE_HIGH_VOLTAGE = 0x06,
+  DRV_DRIVER_ERROR = 0x07,
+};
+
+/**
+ * @brief 电机反馈状态
+ * position rad，speed rad/s，current A，温度 ℃
+ */
+struct Motor_info {
+  uint16_t motor_id;
+  ErrorCode error_code;
+  float position;
+  float speed;
+  float current;
+  uint8_t motor_temperature;
+  uint8_t MOS_temperature;
+};
+
+/**
+ * @brief ENCOS 例程 can_rv.c 中的量程
+ */
+struct Encos_standard {
+  static constexpr const char *NAME = "ENCOS";
+  static constexpr float KP_MIN = 0.0f, KP_MAX = 500.0f;
+  static constexpr float KD_MIN = 0.0f, KD_MAX = 5.0f;
+  static constexpr float POS_MIN = -12.5f, POS_MAX = 12.5f;
+  static constexpr float SPD_MIN = -18.0f, SPD_MAX = 18.0f;
+  static constexpr float T_MIN = -30.0f, T_MAX = 30.0f;
+  static constexpr float I_MIN = -30.0f, I_MAX = 30.0f;
+};
+
+/**
+ * @brief 定点量化，value = raw * SCALE + MIN
+ */
+template <int BITS> struct Quantizer {
+  static constexpr uint32_t MAX_RAW = (1u << BITS) - 1;
+
+  static constexpr float Scale(float min, float max) {
+    return (max - min) / MAX_RAW;
+  }
+
+  static constexpr float Decode(uint32_t raw, float min, float scale) {
+    return static_cast<float>(raw) * scale + min;
+  }
+
+  // 与例程 float_to_uint 的运算顺序一致，保证编码结果逐位相同
+  static constexpr uint32_t Encode(float value, float min, float max) {
+    return static_cast<uint32_t>((std::clamp(value, min, max) - min) *
+                                 static_cast<float>(MAX_RAW) / (max - min));
+  }
+};
+
+template <typename Model> struct Codec {
+  using Q16 = Quantizer<16>;
+  using Q12 = Quantizer<12>;
+  using Q9 = Quantizer<9>;
+
+  static constexpr float POS_SCALE = Q16::Scale(Model::POS_MIN, Model::POS_MAX);
+  static constexpr float SPD_SCALE = Q12::Scale(Model::SPD_MIN, Model::SPD_MAX);
+  static constexpr float I_SCALE = Q12::Scale(Model::I_MIN, Model::I_MAX);
+  static constexpr float T_SCALE = Q12::Scale(Model::T_MIN, Model::T_MAX);
+  static constexpr float KP_SCALE = Q12::Scale(Model::KP_MIN, Model::KP_MAX);
+  static constexpr float KD_SCALE = Q9::Scale(Model::KD_MIN, Model::KD_MAX);
+
+
+  static constexpr float DecodePosition(uint32_t raw) {
+    return Q16::Decode(raw, Model::POS_MIN, POS_SCALE);
+  }
+  static constexpr float DecodeSpeed(uint32_t raw) {
+    return Q12::Decode(raw, Model::SPD_MIN, SPD_SCALE);
+  }
+  static constexpr float DecodeCurrent(uint32_t raw) {
+    return Q12::Decode(raw, Model::I_MIN, I_SCALE);
+  }
+  static constexpr uint8_t DecodeTemperature(uint8_t raw) {
+    return static_cast<uint8_t>((raw - 50) / 2);
+  }
+
+  /**
+   * @brief 解析应答帧 1~3，其余类型返回 STATUS_ERR 且不修改 info
+   */
+  static DWORD DecodeAck(const CAN_OBJ &msg, Motor_info &info) {
+    const BYTE *data = msg.Data;
+    switch ((data[0] >> 5) & 0b111) {
+    case 1:
+      if (msg.DataLen < 8) {
+        return STATUS_ERR;
+      }
+      info.error_code = static_cast<ErrorCode>(data[0] & 0b11111);
+      info.position = DecodePosition(data[1] << 8 | data[2]);
+      info.speed = DecodeSpeed(data[3] << 4 | data[4] >> 4);
+      info.current = DecodeCurrent((data[4] & 0x0F) << 8 | data[5]);
+      info.motor_temperature = DecodeTemperature(data[6]);
+      info.MOS_temperature = DecodeTemperature(data[7]);
+      return STATUS_OK;
+    case 2:
+    case 3: {
+      // 位置或速度为大端单精度浮点，电流单位 0.01 A
+      if (msg.DataLen < 8) {
+        return STATUS_ERR;
+      }
+      float value = std::bit_cast<float>(static_cast<uint32_t>(
+          data[1] << 24 | data[2] << 16 | data[3] << 8 | data[4]));
+      (((data[0] >> 5) & 0b111) == 2 ? info.position : info.speed) = value;
+      info.error_code = static_cast<ErrorCode>(data[0] & 0b11111);
+      info.current = static_cast<int16_t>(data[5] << 8 | data[6]) / 100.0f;
+      info.motor_temperature = DecodeTemperature(data[7]);
+      return STATUS_OK;
+    }
+    default:
+      return STATUS_ERR;
+    }
+  }
+
+  /**
+   * @brief 编码力位混合控制帧
+   */
+  static void EncodeHybrid(CAN_OBJ &msg, float kp, float kd, float position,
+                           float speed, float torque) {
+    uint32_t kp_int = Q12::Encode(kp, Model::KP_MIN, Model::KP_MAX);
+    uint32_t kd_int = Q9::Encode(kd, Model::KD_MIN, Model::KD_MAX);
+    uint32_t pos_int = Q16::Encode(position, Model::POS_MIN, Model::POS_MAX);
+    uint32_t spd_int = Q12::Encode(speed, Model::SPD_MIN, Model::SPD_MAX);
+    uint32_t tor_int = Q12::Encode(torque, Model::T_MIN, Model::T_MAX);
+
+    msg.DataLen = 8;
+    msg.Data[0] = static_cast<uint8_t>(kp_int >> 7);
+    msg.Data[1] = static_cast<uint8_t>((kp_int & 0x7F) << 1 | kd_int >> 8);
+    msg.Data[2] = static_cast<uint8_t>(kd_int);
+    msg.Data[3] = static_cast<uint8_t>(pos_int >> 8);
+    msg.Data[4] = static_cast<uint8_t>(pos_int);
+    msg.Data[5] = static_cast<uint8_t>(spd_int >> 4);
+    msg.Data[6] = static_cast<uint8_t>((spd_int & 0x0F) << 4 | tor_int >> 8);
+    msg.Data[7] = static_cast<uint8_t>(tor_int);
+  }
+};
+
+/**
+ * @brief 类型擦除的型号，供混合型号的电机组使用
+ */
+class Model_handle {
+protected:
+  const char *name;
+  DWORD (*decode_ack)(const CAN_OBJ &msg, Motor_info &info);
+  void (*encode_hybrid)(CAN_OBJ &msg, float kp, float kd, float position,
+                        float speed, float torque);
+
+  constexpr Model_handle(const char *name,
+                         DWORD (*decode_ack)(const CAN_OBJ &, Motor_info &),
+                         void (*encode_hybrid)(CAN_OBJ &, float, float, float,
+                                               float, float))
+      : name(name), decode_ack(decode_ack), encode_hybrid(encode_hybrid) {}
+
+public:
+  template <typename Model> static constexpr Model_handle Of() {
+    return Model_handle(Model::NAME, &Codec<Model>::DecodeAck,
+                        &Codec<Model>::EncodeHybrid);
+  }
+
+  const char *Name() const { return name; }
+
+  DWORD DecodeAck(const CAN_OBJ &msg, Motor_info &info) const {
+    return decode_ack(msg, info);
+  }
+
+  void EncodeHybrid(CAN_OBJ &msg, float kp, float kd, float position,
+                    float speed, float torque) const {
+    encode_hybrid(msg, kp, kd, position, speed, torque);
+  }
+};
+
+} // namespace Motor
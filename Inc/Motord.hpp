@@ -0,0 +1,124 @@
+/**
+ * @file Motord.hpp
+ * @author KalecKKK
+ * @brief motord 总线共享守护进程的协议定义与客户端
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * motord 独占所有 CAN 适配器，客户端通过 Unix 套接字连接：
+ * 控制面在套接字上收发 Motord_request / Motord_response，
+ * 连接成功后守护进程用 SCM_RIGHTS 传回一块共享内存（Motord_region），
+ * 其中的两个 SPSC 环形队列承载收发帧。接收帧在守护进程一侧按电机 ID 过滤。
+ * 客户端断开套接字即释放其队列。
+ */
+
+#pragma once
+
+#include "Can_transport.hpp"
+#include "Spsc_ring.hpp"
+#include <stdint.h>
+#include <vector>
+
+namespace Motord {
+
+constexpr const char *DEFAULT_SOCKET = "/tmp/motord.sock";
+constexpr uint32_t PROTOCOL_MAGIC = 0x444D544D; // "MTMD"
+constexpr uint32_t RING_SIZE = 1024;
+constexpr uint32_t MAX_FILTER_IDS = 64;
+
+enum Request_type : uint32_t {
+  REQUEST_ATTACH = 0x01,     // 连接通道，返回共享内存
+  REQUEST_SET_FILTER = 0x02, // 更新接收过滤
+};
+
+/**
+ * @brief 控制请求
+ * id_count 为 0 表示接收该通道全部帧；否则只接收这些电机的应答帧
+ * 及帧内电机 ID 匹配的 0x7FF 反馈帧，0x7FF 上的广播反馈总是接收
+ */
+struct Motord_request {
+  uint32_t magic;
+  Request_type type;
+  uint32_t channel; // device_index << 1 | can_index
+  uint32_t id_count;
+  uint16_t ids[MAX_FILTER_IDS];
+};
+
+struct Motord_response {
+  uint32_t magic;
+  uint32_t status; // STATUS_OK / STATUS_ERR
+};
+
+/**
+ * @brief 客户端与守护进程之间的共享内存
+ */
+struct Motord_region {
+  Spsc_ring<CAN_OBJ, RING_SIZE> tx; // 客户端生产，守护进程消费
+  Spsc_ring<CAN_OBJ, RING_SIZE> rx; // 守护进程生产，客户端消费
+  alignas(64) std::atomic<uint64_t> rx_dropped;
+};
+
+/**
+ * @brief motord 客户端，接口与 Can_transport 一致
+ */
+class Motord_client {
+protected:
+  int socket_fd;
+  Motord_region *region;
+  mutable uint64_t reported_dropped;
+
+  bool Request(const Motord_request &request, int *fd = nullptr) const;
+
+public:
+  /**
+   * @brief 连接守护进程的一个通道
+   * @param channel 通道号，device_index << 1 | can_index
+   * @param ids 接收过滤的电机 ID，为空表示接收全部
+   * @param socket_path 守护进程套接字
+   */
+  Motord_client(uint32_t channel, const std::vector<uint16_t> &ids = {},
+                const char *socket_path = DEFAULT_SOCKET);
+
+  ~Motord_client();
+
+  Motord_client(const Motord_client &) = delete;
+  Motord_client &operator=(const Motord_client &) = delete;
+
+  /**
+   * @brief 更新接收过滤
+   */
+  bool SetFilter(const std::vector<uint16_t> &ids) const;
+
+  /**
+   * @brief 因接收队列满被守护进程丢弃的帧数
+   */
+  uint64_t DroppedCount() const;
+
+  DWORD Transmit(CAN_OBJ msgs[], ULONG len) const;
+  DWORD Receive(CAN_OBJ msgs[], ULONG len, INT wait_time = 0) const;
+
+  /**
+   * @brief 接收帧的硬件时间戳，由守护进程原样转发
+   * @return uint64_t us，帧未带时间戳时为 0
+   */
+  uint64_t Timestamp(const CAN_OBJ &msg) const {
+    return EcanVci::DeviceTimestamp(msg);
+  }
+
+  /**
+   * @brief 上次读取后接收队列有丢帧时报告 ERR_BUFFEROVERFLOW
+   * @param error 输出错误信息
+   * @return DWORD STATUS_OK
+   */
+  DWORD ReadError(ERR_INFO &error) const;
+
+  DWORD Transmit(UINT destination, BYTE data[], ULONG len) const;
+  DWORD ReceiveOnce(UINT &source, BYTE data[], ULONG &len,
+                    ULONG wait_time = 0) const;
+  DWORD ReceiveLast(UINT &source, BYTE data[], ULONG &len,
+                    ULONG wait_time = 0) const;
+};
+
+} // namespace Motord
@@ -0,0 +1,124 @@
+/**
+ * @file Parameter_manager.hpp
+ * @author KalecKKK
+ * @brief 电机组参数管理：缓存已知参数、跳过重复写入、窗口化流水线回读校验
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 在 Async_executor 上同时运行 window 个工作协程，每个协程依次处理一个电机，
+ * 因此总线上最多有 window 个等待应答的请求。校验模式下写入帧不请求应答，
+ * 随后用参数查询回读确认，每个电机只有一次写入突发加若干次查询往返。
+ *
+ *   Motor::Parameter_manager manager(executor);
+ *   manager.Add(motor);
+ *   Motor::Tuning_profile profile;
+ *   profile.feedback_kp = 800;
+ *   uint32_t failed = manager.Apply(profile);
+ */
+
+#pragma once
+
+#include "Motor_control.hpp"
+#include <array>
+#include <optional>
+#include <stdint.h>
+#include <vector>
+
+namespace Motor {
+
+/**
+ * @brief 调参配置，未设置的参数保持不变
+ */
+struct Tuning_profile {
+  std::optional<uint16_t> acceleration;
+  std::optional<uint16_t> linkage_kp;
+  std::optional<uint16_t> speed_ki;
+  std::optional<uint16_t> feedback_kp;
+  std::optional<uint16_t> feedback_kd;
+};
+
+class Parameter_manager {
+protected:
+  struct Entry {
+    Motor_core *motor;
+    // 按参数指令码索引，只使用 PARAM_ACCELERATION ~ PARAM_FEEDBACK_KD
+    std::array<std::optional<uint16_t>, PARAM_FEEDBACK_KD + 1> cache;
+  };
+
+  typedef Task<DWORD> (Parameter_manager::*Job)(Entry &entry);
+
+  Async_executor &executor;
+  uint32_t window;
+  std::vector<Entry> entries;
+
+  Tuning_profile profile;
+  bool verify;
+  size_t next_entry;
+  uint32_t failed_count, written_count, skipped_count;
+
+  Entry *Find(const Motor_core &motor);
+  const Entry *Find(const Motor_core &motor) const;
+
+  Task<void> Worker(Job job);
+  Task<std::optional<uint16_t>> Read(Entry &entry, Parameter_code code);
+  Task<DWORD> Upload(Entry &entry);
+  Task<DWORD> Refresh(Entry &entry);
+
+  void Schedule(Job job);
+
+public:
+  /**
+   * @param executor 已登记所有电机的执行器
+   * @param window 同时等待应答的最大请求数
+   */
+  explicit Parameter_manager(Async_executor &executor, uint32_t window = 8);
+
+  /**
+   * @brief 加入电机，电机需已 Attach 到执行器
+   */
+  void Add(Motor_core &motor);
+
+  /**
+   * @brief 缓存的参数值
+   * @return std::optional<uint16_t> 未知时为空
+   */
+  std::optional<uint16_t> Cached(const Motor_core &motor,
+                                 Parameter_code code) const;
+
+  /**
+   * @brief 清空缓存，例如电机重新上电后
+   */
+  void Invalidate();
+
+  /**
+   * @brief 把配置写入所有电机的任务交给执行器，由调用方运行执行器
+   * @param profile 调参配置
+   * @param verify 为 true 时写入不请求应答，随后回读校验；否则等待应答帧 1
+   */
+  void ScheduleApply(const Tuning_profile &profile, bool verify = true);
+
+  /**
+   * @brief 回读所有电机的可写参数的任务交给执行器
+   */
+  void ScheduleRefresh();
+
+  /**
+   * @brief ScheduleApply 后运行执行器直到所有任务结束
+   * @return uint32_t 失败的电机数量
+   */
+  uint32_t Apply(const Tuning_profile &profile, bool verify = true);
+
+  /**
+   * @brief ScheduleRefresh 后运行执行器直到所有任务结束
+   * @return uint32_t 失败的电机数量
+   */
+  uint32_t Refresh();
+
+  uint32_t FailedCount() const { return failed_count; }
+  uint32_t WrittenCount() const { return written_count; }
+  uint32_t SkippedCount() const { return skipped_count; }
+};
+
+} // namespace Motor
@@ -0,0 +1,171 @@
+/**
+ * @file Profiler.hpp
+ * @author KalecKKK
+ * @brief 控制周期分阶段计时：编码、驱动发送、驱动接收、解码与用户代码
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 计时点用 MOTOR_PROFILE_SCOPE 声明，只在定义 MOTOR_PROFILE 时
+ * （cmake -DMOTOR_PROFILE=ON）生成代码，否则编译为空语句。
+ * 时钟优先使用不变 TSC（rdtsc），不支持时用 CLOCK_MONOTONIC_RAW。
+ * 每个线程有自己的直方图，记录时不加锁；Report 合并各线程给出 p50/p99/max，
+ * 分桶相对误差不超过 1/16。控制环每周期末尾调用 MOTOR_PROFILE_CYCLE，
+ * 另外保留最慢的若干个周期，含各阶段耗时与逐次计时事件。
+ *
+ *   void Loop() {
+ *     {
+ *       MOTOR_PROFILE_SCOPE(PHASE_USER);
+ *       fleet.Compute(dt);
+ *     }
+ *     fleet.Stage(batch);          // 库内部计入 PHASE_ENCODE
+ *     batch.Transmit(can_transport); // PHASE_TRANSMIT
+ *     MOTOR_PROFILE_CYCLE();
+ *   }
+ *   Profile::Dump();
+ */
+
+#pragma once
+
+#include <array>
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILE_X86 1
+#else
+#define PROFILE_X86 0
+#endif
+
+namespace Profile {
+
+enum Phase : uint8_t {
+  PHASE_ENCODE = 0x00,   // Motor_control 编码命令帧
+  PHASE_TRANSMIT = 0x01, // 驱动的 Transmit
+  PHASE_RECEIVE = 0x02,  // 驱动的 Receive，含阻塞等待
+  PHASE_DECODE = 0x03,   // 解析反馈帧
+  PHASE_USER = 0x04,     // 用户代码
+  PHASE_COUNT = 0x05,
+};
+
+constexpr uint32_t CYCLE_EVENTS = 32;
+
+/**
+ * @brief 一个阶段的统计，单位 ns
+ */
+struct Phase_stats {
+  uint64_t count;
+  double mean, p50, p99, max;
+};
+
+struct Cycle_event {
+  Phase phase;
+  uint64_t start;    // 相对周期开始 ns
+  uint64_t duration; // ns
+};
+
+/**
+ * @brief 一个控制周期的明细，周期为相邻两次 MOTOR_PROFILE_CYCLE 之间
+ */
+struct Cycle_record {
+  uint32_t thread_id;
+  uint64_t start;    // CLOCK_MONOTONIC_RAW ns
+  uint64_t duration; // ns
+  uint64_t phase_time[PHASE_COUNT];
+  uint32_t phase_count[PHASE_COUNT];
+  uint32_t event_count; // 超过 CYCLE_EVENTS 的事件只计入 phase_time
+  Cycle_event events[CYCLE_EVENTS];
+};
+
+// 启动时检测 CPU 是否有不变 TSC
+extern const bool use_tsc;
+
+inline uint64_t RawNow() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * @brief 当前时刻，单位为 TSC 周期或 ns，只用于求差
+ */
+inline uint64_t Ticks() {
+#if PROFILE_X86
+  if (use_tsc) {
+    return __rdtsc();
+  }
+#endif
+  return RawNow();
+}
+
+const char *PhaseName(Phase phase);
+
+/**
+ * @brief 使用的时钟，"TSC" 或 "CLOCK_MONOTONIC_RAW"
+ */
+const char *ClockName();
+
+/**
+ * @brief 计入本线程一次 [start, end) 的计时，时刻由 Ticks 取得
+ */
+void Record(Phase phase, uint64_t start, uint64_t end);
+
+/**
+ * @brief 结束本线程的当前周期，开始下一个
+ */
+void EndCycle();
+
+/**
+ * @brief 每个线程保留的最慢周期数，0 关闭，默认 8
+ */
+void SetSlowestCount(uint32_t count);
+
+/**
+ * @brief 合并所有线程的各阶段统计
+ */
+std::array<Phase_stats, PHASE_COUNT> Report();
+
+/**
+ * @brief 所有线程中最慢的周期，按耗时从大到小
+ */
+std::vector<Cycle_record> Slowest();
+
+/**
+ * @brief 把 Report 与 Slowest 写入日志
+ * @param detail 是否输出最慢周期的逐次计时事件
+ */
+void Dump(bool detail = true);
+
+/**
+ * @brief 清空所有线程的统计与最慢周期
+ */
+void Reset();
+
+class Scope {
+  Phase phase;
+  uint64_t start;
+
+public:
+  explicit Scope(Phase phase) : phase(phase), start(Ticks()) {}
+  ~Scope() { Record(phase, start, Ticks()); }
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+};
+
+} // namespace Profile
+
+#ifdef MOTOR_PROFILE
+#define MOTOR_PROFILE_CONCAT_(a, b) a##b
+#define MOTOR_PROFILE_CONCAT(a, b) MOTOR_PROFILE_CONCAT_(a, b)
+#define MOTOR_PROFILE_SCOPE(phase)                                             \
+  ::Profile::Scope MOTOR_PROFILE_CONCAT(profile_scope_, __LINE__)(             \
+      ::Profile::phase)
+#define MOTOR_PROFILE_CYCLE() ::Profile::EndCycle()
+#else
+#define MOTOR_PROFILE_SCOPE(phase) static_cast<void>(0)
+#define MOTOR_PROFILE_CYCLE() static_cast<void>(0)
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file Receive_engine.hpp
+ * @author KalecKKK
+ * @brief 后台接收线程与 eventfd，使 CAN 接收可加入调用方的 epoll
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 厂商驱动没有可等待的描述符，接收线程阻塞在驱动的 Receive 上（不自旋），
+ * 把收到的帧写入 SPSC 环形队列并使 eventfd 可读。调用方在 epoll 中等待
+ * Fd()，可读时用 Drain 非阻塞取走全部帧。本类自身也满足 Can_backend，
+ * 可直接交给 Async_executor，在 Fd() 可读时调用 Poll(0)：
+ *
+ *   EcanVci::Receive_engine engine(can_transport);
+ *   Motor::Async_executor executor(engine);
+ *   epoll_ctl(epoll_fd, EPOLL_CTL_ADD, engine.Fd(), &event);
+ *   // Fd() 可读或 executor.NextDeadline() 到期时
+ *   executor.Poll(0);
+ *
+ * SocketCAN 的套接字本身可等待，直接使用 Socket_can_transport::Fd()。
+ *
+ * 后端的 Receive 在接收线程中调用，Transmit、Timestamp、ReadError 在调用方
+ * 线程中调用，后端须允许二者并发；库中的后端均满足这一要求。
+ */
+
+#pragma once
+
+#include "Can_backend.hpp"
+#include "Spsc_ring.hpp"
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <thread>
+
+namespace EcanVci {
+
+class Receive_engine {
+public:
+  static constexpr uint32_t RING_SIZE = 1024;
+
+protected:
+  Can_backend_handle backend;
+  INT wait_time;
+  int event_fd;
+  std::unique_ptr<Spsc_ring<CAN_OBJ, RING_SIZE>> ring;
+
+  std::atomic<bool> running;
+  std::atomic<uint64_t> dropped;
+  mutable uint64_t reported_dropped;
+  std::thread thread;
+
+  void Loop();
+  void Signal() const;
+
+public:
+  /**
+   * @brief 启动接收线程
+   * @param backend 接收后端，须比本对象活得久，Receive 须可与其余接口并发
+   * @param wait_time 接收线程每次阻塞在驱动上的最长时间 ms，决定析构时的等待
+   * @note eventfd 创建失败时抛出 std::runtime_error
+   */
+  explicit Receive_engine(Can_backend_handle backend, INT wait_time = 10);
+
+  ~Receive_engine();
+
+  Receive_engine(const Receive_engine &) = delete;
+  Receive_engine &operator=(const Receive_engine &) = delete;
+
+  /**
+   * @brief 队列中有帧时可读的 eventfd，非阻塞
+   */
+  int Fd() const { return event_fd; }
+
+  /**
+   * @brief 非阻塞取出已缓冲的帧，取完后 Fd() 不再可读
+   * @param msgs 帧数组
+   * @param len 最多取出的帧数量
+   * @return DWORD 实际取出的帧数量
+   */
+  DWORD Drain(CAN_OBJ msgs[], ULONG len) const;
+
+  /**
+   * @brief 因队列满被丢弃的帧数
+   */
+  uint64_t DroppedCount() const {
+    return dropped.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 直接由后端发送，不经过接收线程
+   */
+  DWORD Transmit(CAN_OBJ msgs[], ULONG len) const {
+    return backend.Transmit(msgs, len);
+  }
+
+  /**
+   * @brief 取出已缓冲的帧，没有帧时在 eventfd 上最多等待 wait_time ms
+   */
+  DWORD Receive(CAN_OBJ msgs[], ULONG len, INT wait_time = 0) const;
+
+  uint64_t Timestamp(const CAN_OBJ &msg) const {
+    return backend.Timestamp(msg);
+  }
+
+  /**
+   * @brief 更新后端的接收过滤，后端不支持时接收全部帧
+   */
+  DWORD SetFilter(const std::vector<uint16_t> &ids) const {
+    return backend.SetFilter(ids);
+  }
+
+  /**
+   * @brief 后端的错误信息，上次读取后队列有丢帧时附加 ERR_BUFFEROVERFLOW
+   */
+  DWORD ReadError(ERR_INFO &error) const;
+};
+
+} // namespace EcanVci
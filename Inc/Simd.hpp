@@ -0,0 +1,93 @@
+/**
+ * @file Simd.hpp
+ * @author KalecKKK
+ * @brief 向量化内核与运行时指令集选择
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 内核按 AVX2、SSE2、标量三级实现，首次调用时按 CPU 支持情况选择，
+ * 编译时无需 -mavx2。各级实现的运算顺序相同，结果逐位一致。
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace Simd {
+
+enum Level {
+  LEVEL_SCALAR = 0x00,
+  LEVEL_SSE2 = 0x01,
+  LEVEL_AVX2 = 0x02,
+};
+
+/**
+ * @brief 当前使用的指令集
+ */
+Level GetLevel();
+
+/**
+ * @brief 强制使用不高于 CPU 支持的指令集，用于对比测试
+ */
+void SetLevel(Level level);
+
+const char *LevelName(Level level);
+
+/**
+ * @brief out[i] = raw[i] * scale + offset
+ */
+void Affine(const int32_t raw[], float out[], uint32_t len, float scale,
+            float offset);
+
+/**
+ * @brief 一组轴的 PID 输入输出，均为长度 len 的数组（SoA）
+ */
+struct Pid_arrays {
+  const float *kp, *ki, *kd;
+  const float *kaw; // 抗饱和反算增益
+  const float *output_min, *output_max;
+  const float *position_setpoint, *speed_setpoint, *feedforward;
+  const float *position, *speed;
+  float *integral; // 积分项，原地更新
+  float *output;
+};
+
+/**
+ * @brief 位置 PID，微分项取速度误差，输出限幅后以反算法更新积分：
+ *        u = kp * e + integral + kd * de + feedforward
+ *        output = clamp(u, output_min, output_max)
+ *        integral += dt * (ki * e + kaw * (output - u))
+ *        u 为 NaN 时 output 为 output_min，各级实现相同
+ */
+void Pid(const Pid_arrays &arrays, uint32_t len, float dt);
+
+/**
+ * @brief 一组轴的 α-β 滤波输入输出，均为长度 len 的数组（SoA）
+ */
+struct Alpha_beta_arrays {
+  const float *measured_position, *measured_speed;
+  const float *dt; // 距上次估计的时间 s
+  // 位置残差增益 α、速度残差增益 β / dt、速度测量融合权重，
+  // 三者与 dt 均为 0 的轴保持不变
+  const float *position_gain, *speed_gain, *speed_weight;
+  float *position, *speed; // 估计值，原地更新
+};
+
+/**
+ * @brief α-β 滤波一步：
+ *        predicted = position + speed * dt
+ *        r = measured_position - predicted
+ *        position = predicted + position_gain * r
+ *        speed += speed_gain * r + speed_weight * (measured_speed - speed)
+ */
+void AlphaBeta(const Alpha_beta_arrays &arrays, uint32_t len);
+
+/**
+ * @brief out[i] = position[i] + speed[i] * lead[i]
+ */
+void Extrapolate(const float position[], const float speed[],
+                 const float lead[], float out[], uint32_t len);
+
+} // namespace Simd
@@ -0,0 +1,130 @@
+/**
+ * @file Socket_can_transport.hpp
+ * @author KalecKKK
+ * @brief Linux SocketCAN 收发，接口与 Can_transport 一致
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 直接使用内核 CAN_RAW 套接字，不经过 USB 驱动：
+ * 批量收发使用 sendmmsg/recvmmsg，每次系统调用处理一整批帧；
+ * 接收过滤由内核按电机 ID 完成（CAN_RAW_FILTER），交给 Async_executor 时
+ * 随 Attach 登记的电机更新；
+ * 接收时间戳取自 SO_TIMESTAMPING，有硬件时间戳时优先使用，否则把内核的
+ * 软件时间戳（CLOCK_REALTIME）换算到 CLOCK_MONOTONIC，不随系统校时跳变。
+ * CAN_OBJ::TimeStamp 只存 us 的低 32 位，约 71.6 分钟回绕一次，
+ * 完整时间由 Timestamp() 以最近一次接收补齐。
+ * 接口的波特率由 ip link 配置，可在 vcan 虚拟接口上测试：
+ *
+ *   ip link add dev vcan0 type vcan && ip link set up vcan0
+ *   EcanVci::Socket_can_transport can_transport("vcan0", {0x01, 0x02});
+ */
+
+#pragma once
+
+#include "Can_backend.hpp"
+#include "Can_capture.hpp"
+#include "ECanVci.h"
+#include <atomic>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace EcanVci {
+
+class Socket_can_transport {
+protected:
+  int socket_fd, ifindex;
+  std::string interface;
+  uint32_t bitrate;
+
+  const Can_capture *capture;
+
+  // Receive 可能在 Receive_engine 的接收线程中调用，与调用方线程的
+  // Timestamp、ReadError 并发，二者共享的状态为原子量
+  // 内核时间戳的 us 低 32 位存放在 CAN_OBJ::TimeStamp，高位由最近一次接收补齐
+  mutable std::atomic<uint64_t> last_timestamp;
+  // 接收过程中由错误帧和内核丢帧计数累积，ReadError 读取后清除
+  mutable std::atomic<UINT> pending_errors;
+  mutable uint32_t reported_dropped; // 只由 Receive 访问
+
+public:
+  /**
+   * @brief 打开并绑定 CAN_RAW 套接字
+   * @param interface 网络接口名，如 can0、vcan0
+   * @param ids 接收过滤的电机 ID，为空表示接收全部
+   * @param bitrate 接口波特率 bit/s，仅用于带宽预算，由 ip link 配置
+   * @note 接口不存在或套接字创建失败时抛出 std::runtime_error
+   */
+  Socket_can_transport(const std::string &interface,
+                       const std::vector<uint16_t> &ids = {},
+                       uint32_t bitrate = 1000000);
+
+  ~Socket_can_transport();
+
+  Socket_can_transport(const Socket_can_transport &) = delete;
+  Socket_can_transport &operator=(const Socket_can_transport &) = delete;
+
+  /**
+   * @brief 更新内核接收过滤
+   * @param ids 电机 ID，只接收这些电机的应答帧与全部 0x7FF 反馈帧；
+   *            为空表示接收全部
+   * @return DWORD STATUS_OK 或 STATUS_ERR
+   */
+  DWORD SetFilter(const std::vector<uint16_t> &ids) const;
+
+  /**
+   * @brief 套接字描述符，可加入调用方的 epoll
+   */
+  int Fd() const { return socket_fd; }
+
+  const std::string &Interface() const { return interface; }
+
+  uint32_t Bitrate() const { return bitrate; }
+
+  /**
+   * @brief 挂载抓包，之后所有收发帧都写入抓包文件，通道号为 0
+   * @param capture 抓包写入端，nullptr 表示关闭
+   */
+  void AttachCapture(const Can_capture *capture);
+
+  /**
+   * @brief 批量发送，一次 sendmmsg
+   * @param msgs 帧数组
+   * @param len 帧数量
+   * @return DWORD 实际发送的帧数量，发送队列满时少于 len
+   */
+  DWORD Transmit(CAN_OBJ msgs[], ULONG len) const;
+
+  /**
+   * @brief 批量接收，一次 recvmmsg 取走已到达的帧
+   * @param msgs 帧数组
+   * @param len 最多接收的帧数量
+   * @param wait_time 没有帧时的等待时间 ms
+   * @return DWORD 实际接收的帧数量，不含错误帧
+   */
+  DWORD Receive(CAN_OBJ msgs[], ULONG len, INT wait_time = 0) const;
+
+  /**
+   * @brief 接收帧的时间戳：硬件时钟，或 CLOCK_MONOTONIC
+   * @return uint64_t us，帧未带时间戳时为 0；帧须在接收后约 35 分钟内
+   *         （2^31 us）处理，否则高位补齐出错
+   */
+  uint64_t Timestamp(const CAN_OBJ &msg) const;
+
+  /**
+   * @brief 读取并清除上次读取后的错误：总线错误帧与套接字接收队列丢帧
+   * @param error 输出错误信息
+   * @return DWORD STATUS_OK
+   */
+  DWORD ReadError(ERR_INFO &error) const;
+
+  DWORD Transmit(UINT destination, BYTE data[], ULONG len) const;
+  DWORD ReceiveOnce(UINT &source, BYTE data[], ULONG &len,
+                    ULONG wait_time = 0) const;
+  DWORD ReceiveLast(UINT &source, BYTE data[], ULONG &len,
+                    ULONG wait_time = 0) const;
+};
+
+} // namespace EcanVci
@@ -0,0 +1,75 @@
+/**
+ * @file Spsc_ring.hpp
+ * @author KalecKKK
+ * @brief 单生产者单消费者无锁环形队列，布局固定，可直接放在共享内存中
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <stdint.h>
+#include <type_traits>
+
+template <typename T, uint32_t N> struct Spsc_ring {
+  static_assert((N & (N - 1)) == 0, "Capacity must be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>);
+  static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
+  alignas(64) std::atomic<uint32_t> head; // 生产者写
+  alignas(64) std::atomic<uint32_t> tail; // 消费者写
+  alignas(64) T items[N];
+
+  void Reset() {
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+  }
+
+  static constexpr uint32_t Capacity() { return N; }
+
+  uint32_t Size() const {
+    return head.load(std::memory_order_acquire) -
+           tail.load(std::memory_order_acquire);
+  }
+
+  bool Empty() const { return Size() == 0; }
+
+  /**
+   * @brief 生产者批量写入
+   * @return uint32_t 实际写入数量，队列满时少于 len
+   */
+  uint32_t Push(const T values[], uint32_t len) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t free = N - (h - tail.load(std::memory_order_acquire));
+    len = std::min(len, free);
+    for (uint32_t i = 0; i < len; i++) {
+      items[(h + i) & (N - 1)] = values[i];
+    }
+    head.store(h + len, std::memory_order_release);
+    return len;
+  }
+
+  bool Push(const T &value) { return Push(&value, 1) == 1; }
+
+  /**
+   * @brief 消费者批量读出
+   * @return uint32_t 实际读出数量
+   */
+  uint32_t Pop(T values[], uint32_t len) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t used = head.load(std::memory_order_acquire) - t;
+    len = std::min(len, used);
+    for (uint32_t i = 0; i < len; i++) {
+      values[i] = items[(t + i) & (N - 1)];
+    }
+    tail.store(t + len, std::memory_order_release);
+    return len;
+  }
+
+  bool Pop(T &value) { return Pop(&value, 1) == 1; }
+};
@@ -0,0 +1,146 @@
+/**
+ * @file Sync_commit.hpp
+ * @author KalecKKK
+ * @brief 多通道、多适配器的同步提交：先暂存一个周期的全部设定值，再同时发出
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 每个通道一个 Frame_batch，电机通过 Stage* 写入所属通道的批次。
+ * Commit 时每个设备的常驻线程被提前唤醒，自旋等到同一个放行时刻再调用
+ * Transmit，避免逐个设备发送时后面的设备等待前面的驱动调用；
+ * 同一适配器的通道由同一个线程依次发送，厂商驱动不会被并发调用。
+ * 空批次的通道不调用驱动。每次提交测量各通道进入与退出驱动调用的时间差
+ * （偏差）以及整次提交的耗时。
+ *
+ *   Motor::Sync_commit sync;
+ *   uint32_t left = sync.AddChannel(can_1), right = sync.AddChannel(can_2);
+ *   // 每周期
+ *   sync.Clear();
+ *   motor_left.StagePosition(sync.Batch(left), ...);
+ *   motor_right.StagePosition(sync.Batch(right), ...);
+ *   Motor::Commit_report report = sync.Commit();
+ */
+
+#pragma once
+
+#include "Can_transport.hpp"
+#include "Frame_batch.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace Motor {
+
+struct Commit_report {
+  std::chrono::nanoseconds release_skew;    // 各通道开始发送的最大时间差
+  std::chrono::nanoseconds completion_skew; // 各通道发送完成的最大时间差
+  std::chrono::nanoseconds release_lag;     // 最后一个通道晚于放行时刻的时间
+  std::chrono::nanoseconds duration;        // 调用 Commit 到最后一个通道完成
+  uint32_t frames;                          // 实际发送的帧数
+  uint32_t failed;                          // 未发完的通道数
+};
+
+class Sync_commit {
+protected:
+  struct Channel {
+    EcanVci::Can_backend_handle backend;
+    Frame_batch batch;
+    std::chrono::steady_clock::time_point begin, end;
+    DWORD sent;
+
+    Channel(EcanVci::Can_backend_handle backend, uint32_t capacity)
+        : backend(backend), batch(capacity), sent(0) {}
+  };
+
+  // 一个设备的通道由同一个工作线程依次发送
+  struct Device {
+    uint32_t key;
+    std::vector<Channel *> channels;
+    std::thread worker;
+  };
+
+  static constexpr uint32_t DEVICE_NONE = UINT32_MAX;
+
+  bool parallel;
+  std::chrono::nanoseconds arm_time;
+  std::vector<std::unique_ptr<Channel>> channels;
+  std::vector<std::unique_ptr<Device>> devices;
+
+  // Commit 写 release_at 后递增 epoch 唤醒工作线程，工作线程完成后递减 pending
+  std::chrono::steady_clock::time_point release_at;
+  std::atomic<uint32_t> epoch;
+  std::atomic<uint32_t> pending;
+  std::atomic<bool> running;
+
+  uint64_t commits;
+  std::chrono::nanoseconds max_skew, total_skew;
+
+  uint32_t AddToDevice(EcanVci::Can_backend_handle backend, uint32_t capacity,
+                       uint32_t device);
+  void Worker(Device &device, uint32_t seen);
+  static void Send(Device &device);
+
+public:
+  /**
+   * @param parallel 为 false 时在调用线程中逐个通道发送，不创建线程；
+   *        并行发送需要每个设备一个空闲核，核数不足时偏差反而变大
+   * @param arm_time 唤醒工作线程到放行的提前量，需大于线程唤醒延迟
+   */
+  explicit Sync_commit(
+      bool parallel = true,
+      std::chrono::microseconds arm_time = std::chrono::microseconds(50));
+
+  ~Sync_commit();
+
+  Sync_commit(const Sync_commit &) = delete;
+  Sync_commit &operator=(const Sync_commit &) = delete;
+
+  /**
+   * @brief 加入一个独立设备上的通道（SocketCAN、motord 等），
+   *        不可与 Commit 并发调用
+   * @param backend 收发后端，须比本对象活得久
+   * @param capacity 每周期最多的帧数
+   * @return uint32_t 通道下标
+   */
+  uint32_t AddChannel(EcanVci::Can_backend_handle backend,
+                      uint32_t capacity = 64) {
+    return AddToDevice(backend, capacity, DEVICE_NONE);
+  }
+
+  /**
+   * @brief 加入厂商适配器的通道，与同一适配器已加入的通道共用工作线程
+   */
+  uint32_t AddChannel(const EcanVci::Can_transport &transport,
+                      uint32_t capacity = 64) {
+    return AddToDevice(transport, capacity, transport.Device());
+  }
+
+  Frame_batch &Batch(uint32_t channel) { return channels.at(channel)->batch; }
+
+  uint32_t Size() const { return static_cast<uint32_t>(channels.size()); }
+
+  /**
+   * @brief 清空所有通道的批次，每周期暂存前调用
+   */
+  void Clear();
+
+  /**
+   * @brief 同时发出所有通道的批次并等待完成
+   * @return Commit_report 本次提交的偏差，空批次的通道不计入
+   */
+  Commit_report Commit();
+
+  uint64_t Commits() const { return commits; }
+  std::chrono::nanoseconds MaxSkew() const { return max_skew; }
+  std::chrono::nanoseconds MeanSkew() const {
+    return commits ? total_skew / static_cast<int64_t>(commits)
+                   : std::chrono::nanoseconds(0);
+  }
+};
+
+} // namespace Motor
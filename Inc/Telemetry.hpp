@@ -0,0 +1,185 @@
+/**
+ * @file Telemetry.hpp
+ * @author KalecKKK
+ * @brief 通过 POSIX 共享内存向其他进程发布电机状态与命令历史
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 每台电机一个槽，槽内容由 seqlock 保护：写端以 CAS 把 sequence 由偶数加一
+ * （奇数表示写入中），写完再加一；同一槽的状态与命令可由不同线程写入，CAS 使写端互斥。
+ * 读端直接读映射内存，前后 sequence 一致且为偶数即为有效数据，重试次数有上限，
+ * 写端进程在写入中途退出时读端不会卡住。
+ * 头部的 generation 每次写入递增，读端可据此判断是否有新数据。
+ * 写端开销与读端数量无关，读端每次采样不需要系统调用。
+ */
+
+#pragma once
+
+#include "Motor_control.hpp"
+#include <atomic>
+#include <stdint.h>
+#include <string>
+
+namespace Motor {
+
+constexpr uint32_t TELEMETRY_HISTORY = 16;
+
+struct Telemetry_command {
+  uint64_t timestamp; // CLOCK_MONOTONIC，单位 ns
+  uint32_t id;
+  uint8_t data_len;
+  uint8_t data[8];
+  uint8_t reserved[3];
+};
+
+struct alignas(64) Telemetry_slot {
+  std::atomic<uint32_t> sequence;
+  uint16_t motor_id;
+  uint16_t reserved;
+  uint64_t generation;       // 最近一次写入时的全局 generation
+  uint64_t update_timestamp; // 最近一次状态更新，CLOCK_MONOTONIC，单位 ns
+  Motor_control::Motor_info info;
+  uint64_t command_count; // 命令总数，最近一条在 history[(count - 1) % N]
+  Telemetry_command history[TELEMETRY_HISTORY];
+};
+
+struct alignas(64) Telemetry_header {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t slot_size;
+  uint32_t slot_count;
+  uint32_t history_size;
+  std::atomic<uint64_t> generation;
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+/**
+ * @brief 写端，一个共享内存区只能有一个写端对象，可在多个线程中调用
+ */
+class Telemetry_publisher {
+protected:
+  std::string name;
+  Telemetry_header *header;
+  Telemetry_slot *slots;
+  size_t mapped_size;
+
+  // 占用槽：sequence 为偶数时以 CAS 改为奇数，另一线程写入中则等待
+  void BeginWrite(Telemetry_slot &slot) const {
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    do {
+      while (sequence & 1) {
+        sequence = slot.sequence.load(std::memory_order_relaxed);
+      }
+    } while (!slot.sequence.compare_exchange_weak(sequence, sequence + 1,
+                                                  std::memory_order_acquire,
+                                                  std::memory_order_relaxed));
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void EndWrite(Telemetry_slot &slot) const {
+    slot.generation =
+        header->generation.fetch_add(1, std::memory_order_relaxed) + 1;
+    slot.sequence.fetch_add(1, std::memory_order_release);
+  }
+
+public:
+  /**
+   * @brief 创建共享内存区，同名区域已存在时删除后重新创建，
+   * 仍连接旧区域的读端须重新连接
+   * @param name 共享内存名，如 "/motor_telemetry"
+   * @param slot_count 槽数量
+   */
+  Telemetry_publisher(const std::string &name, uint32_t slot_count);
+
+  ~Telemetry_publisher();
+
+  Telemetry_publisher(const Telemetry_publisher &) = delete;
+  Telemetry_publisher &operator=(const Telemetry_publisher &) = delete;
+
+  uint32_t SlotCount() const { return header->slot_count; }
+
+  /**
+   * @brief 发布电机状态
+   */
+  void Publish(uint32_t index, uint16_t motor_id,
+               const Motor_control::Motor_info &info) const;
+
+  /**
+   * @brief 追加一条命令到命令历史
+   */
+  void RecordCommand(uint32_t index, const CAN_OBJ &msg) const;
+};
+
+/**
+ * @brief 读端，只读映射，可以有任意多个
+ */
+class Telemetry_reader {
+public:
+  // 等待写入完成或重读的最大次数
+  static constexpr uint32_t READ_RETRIES = 4096;
+
+protected:
+  const Telemetry_header *header;
+  const Telemetry_slot *slots;
+  size_t mapped_size;
+
+public:
+  /**
+   * @brief 连接到已存在的共享内存区
+   */
+  explicit Telemetry_reader(const std::string &name);
+
+  ~Telemetry_reader();
+
+  Telemetry_reader(const Telemetry_reader &) = delete;
+  Telemetry_reader &operator=(const Telemetry_reader &) = delete;
+
+  uint32_t SlotCount() const { return header->slot_count; }
+
+  /**
+   * @brief 全局写入计数，不变则没有新数据
+   */
+  uint64_t Generation() const {
+    return header->generation.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief 直接访问槽，需配合 BeginRead / EndRead 使用
+   */
+  const Telemetry_slot &Slot(uint32_t index) const { return slots[index]; }
+
+  /**
+   * @brief 开始读槽，返回的值交给 EndRead 校验
+   * @note 写入超过 READ_RETRIES 次仍未完成时返回奇数，EndRead 必然失败
+   */
+  uint32_t BeginRead(uint32_t index) const {
+    uint32_t sequence = slots[index].sequence.load(std::memory_order_acquire);
+    for (uint32_t i = 0; (sequence & 1) && i < READ_RETRIES; i++) {
+      sequence = slots[index].sequence.load(std::memory_order_acquire);
+    }
+    return sequence;
+  }
+
+  /**
+   * @brief 结束读槽
+   * @return bool 读到的数据是否有效，无效时应重读
+   */
+  bool EndRead(uint32_t index, uint32_t sequence) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return !(sequence & 1) &&
+           slots[index].sequence.load(std::memory_order_relaxed) == sequence;
+  }
+
+  /**
+   * @brief 读取一致的状态快照
+   * @return bool 重读 READ_RETRIES 次仍不一致时返回 false，输出内容无效
+   */
+  bool Read(uint32_t index, uint16_t &motor_id,
+            Motor_control::Motor_info &info) const;
+};
+
+} // namespace Motor
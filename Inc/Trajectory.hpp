@@ -0,0 +1,99 @@
+/**
+ * @file Trajectory.hpp
+ * @author KalecKKK
+ * @brief 多轴轨迹：途经点（梯形或 S 形速度曲线）与按控制周期采样的位置序列
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 途经点之间按起止速度为零的速度曲线运动，各轴以位移最大的轴规划，
+ * 同时出发同时到达。采样段的每一行为一个控制周期的各轴位置。
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace Motor {
+
+enum Profile_type : uint8_t {
+  PROFILE_TRAPEZOID = 0x00, // 加速度阶跃
+  PROFILE_S_CURVE = 0x01,   // 加加速度受限
+};
+
+struct Profile_limits {
+  float speed;        // rad/s
+  float acceleration; // rad/s^2
+  float jerk = 0.0f;  // rad/s^3，仅 S 形曲线使用，不大于 0 时按梯形规划
+};
+
+/**
+ * @brief 起止速度为零的一维速度曲线，梯形为 S 形在加加速度无穷大时的特例
+ */
+class Motion_profile {
+protected:
+  double distance;
+  double speed_limit, acceleration_limit, jerk;
+  // 加速段、加速段中的加加速度段、匀速段时长 s
+  double acceleration_time, jerk_time, cruise_time;
+
+public:
+  Motion_profile();
+
+  /**
+   * @param distance 位移，可为负
+   */
+  static Motion_profile Plan(Profile_type type, double distance,
+                             const Profile_limits &limits);
+
+  double Duration() const { return 2 * acceleration_time + cruise_time; }
+
+  /**
+   * @brief 采样
+   * @param t 时刻 s，超出 [0, Duration()] 时取端点
+   * @param position 输出，相对起点的位移
+   * @param speed 输出
+   */
+  void Sample(double t, double &position, double &speed) const;
+};
+
+class Trajectory {
+public:
+  struct Segment {
+    bool sampled;
+    Profile_type type;
+    Profile_limits limits;
+    // 在 values 中的起始行与行数，途经点为 1 行
+    uint32_t first_row, rows;
+  };
+
+protected:
+  uint32_t axes;
+  std::vector<Segment> segments;
+  std::vector<float> values;
+
+public:
+  explicit Trajectory(uint32_t axes);
+
+  /**
+   * @brief 追加途经点，从上一段的终点按速度曲线运动到 target
+   * @param target 各轴目标位置 rad，长度为 Axes()
+   */
+  void AddWaypoint(const float target[], const Profile_limits &limits,
+                   Profile_type type = PROFILE_TRAPEZOID);
+
+  /**
+   * @brief 追加采样段
+   * @param positions 按行存放，每行为一个控制周期的各轴位置 rad
+   * @param ticks 行数
+   */
+  void AddSamples(const float positions[], uint32_t ticks);
+
+  uint32_t Axes() const { return axes; }
+  const std::vector<Segment> &Segments() const { return segments; }
+  const float *Row(uint32_t row) const { return &values[row * axes]; }
+};
+
+} // namespace Motor
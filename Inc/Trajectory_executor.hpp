@@ -0,0 +1,172 @@
+/**
+ * @file Trajectory_executor.hpp
+ * @author KalecKKK
+ * @brief 轨迹执行：提前把每个控制周期的帧编码进环形缓冲，实时线程只发送
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 生产者（非实时线程）调用 Load/Fill 采样轨迹并编码，每个周期一个 Frame_batch，
+ * 最多领先 lead 个周期；实时线程每周期调用 Tick 发送一批，不做浮点运算。
+ * 两侧按单生产者单消费者同步，可以在不同线程。
+ *
+ * Preempt/Blend 在生产者一侧替换正在执行的轨迹：已编码的帧不再改写，
+ * 而是提高代号，实时线程跳过旧代号中切换点之后的帧。切换点为实时线程
+ * 当前位置之后 keep 个周期，新轨迹从该周期的设定值出发。
+ *
+ *   Motor::Trajectory_executor executor(0.0005f);
+ *   executor.Add(motor, {.kp = 50.0f, .kd = 1.0f});
+ *   executor.Load(trajectory);
+ *   // 生产者线程
+ *   executor.Fill();
+ *   // 实时线程每周期
+ *   executor.Tick(can_transport);
+ */
+
+#pragma once
+
+#include "Frame_batch.hpp"
+#include "Motor_control.hpp"
+#include "Trajectory.hpp"
+#include <atomic>
+#include <deque>
+#include <stdint.h>
+#include <vector>
+
+namespace Motor {
+
+enum Trajectory_command : uint8_t {
+  COMMAND_HYBRID = 0x00,   // 力位混合帧，带位置与速度设定值
+  COMMAND_POSITION = 0x01, // 位置帧，带速度与电流限制
+};
+
+struct Trajectory_axis {
+  Trajectory_command command = COMMAND_HYBRID;
+  float kp = 0.0f, kd = 0.0f;
+  uint16_t speed_limit = 0, current_limit = 0;
+  Message_return_status ack_status = ACK_TYPE_1;
+};
+
+class Trajectory_executor {
+protected:
+  struct Slot {
+    Frame_batch batch;
+    uint64_t sequence;
+    uint32_t generation;
+    // 编码的设定值，供抢占时确定新轨迹的起点与混合
+    std::vector<float> position, speed;
+
+    explicit Slot(uint32_t axes)
+        : batch(axes), sequence(0), generation(0), position(axes),
+          speed(axes) {}
+  };
+
+  struct Axis {
+    const Motor_core *motor;
+    Trajectory_axis config;
+  };
+
+  float period;
+  uint32_t lead;
+  std::vector<Axis> axes;
+  std::vector<Slot> slots;
+  uint64_t mask;
+
+  // 生产者写 produced、generation、cut，消费者写 consumed
+  alignas(64) std::atomic<uint64_t> produced;
+  alignas(64) std::atomic<uint64_t> consumed;
+  alignas(64) std::atomic<uint32_t> generation;
+  std::atomic<uint64_t> cut;
+  std::atomic<uint64_t> underruns;
+
+  // 以下只由生产者访问，head 为下一个编码的序号，发布前领先 produced
+  uint64_t head;
+  std::deque<Trajectory> queue;
+  size_t segment;
+  uint64_t tick;
+  Motion_profile profile;
+  double distance;
+  std::vector<float> start, delta;
+  std::vector<float> position, speed;
+  // 混合：新轨迹前 blend_ticks 个周期与旧轨迹 [blend_from, blend_end) 的帧插值
+  uint64_t blend_from, blend_end;
+  uint32_t blend_ticks, blended;
+  // 抢占后被跳过的旧帧 [stale_begin, stale_end)
+  uint64_t stale_begin, stale_end;
+
+  void Prepare();
+  bool Advance();
+  void Produce(uint32_t slot_generation);
+  uint32_t Fill(uint32_t slot_generation);
+  // 不含待跳过旧帧的领先周期数
+  uint64_t Ahead(uint64_t tail) const;
+  DWORD Replace(const Trajectory &trajectory, uint32_t keep,
+                uint32_t blend_ticks);
+
+public:
+  /**
+   * @param period 控制周期 s
+   * @param lead 最多提前编码的周期数
+   */
+  explicit Trajectory_executor(float period, uint32_t lead = 32);
+
+  /**
+   * @brief 加入一个轴，起点取电机当前的 motor_info.position
+   * @return uint32_t 轴下标，即轨迹中的列
+   * @note 已开始 Load 后再加入抛出 std::runtime_error
+   */
+  uint32_t Add(const Motor_core &motor, const Trajectory_axis &config = {});
+
+  /**
+   * @brief 在当前轨迹之后排队
+   * @note 轨迹轴数与已加入的轴数不符时抛出 std::runtime_error
+   */
+  void Load(const Trajectory &trajectory);
+
+  /**
+   * @brief 抢占：丢弃排队与未发送的帧，keep 个周期后切换到新轨迹
+   * @return DWORD 上一次抢占尚未生效时返回 STATUS_ERR
+   */
+  DWORD Preempt(const Trajectory &trajectory, uint32_t keep = 2);
+
+  /**
+   * @brief 与 Preempt 相同，但新轨迹前 blend_ticks 个周期与
+   *        已编码的旧帧平滑插值，插值长度不超过已编码的旧帧数
+   */
+  DWORD Blend(const Trajectory &trajectory, uint32_t blend_ticks,
+              uint32_t keep = 2);
+
+  /**
+   * @brief 生产者：编码直到领先 lead 个周期或轨迹结束
+   * @return uint32_t 本次编码的周期数
+   */
+  uint32_t Fill();
+
+  /**
+   * @brief 实时线程：发送下一个周期的帧
+   * @return DWORD 发送的帧数，没有已编码的帧时为 0 并计入欠载
+   */
+  DWORD Tick(EcanVci::Can_backend_handle can_transport);
+
+  /**
+   * @brief 生产者一侧：轨迹已全部编码
+   */
+  bool Idle() const { return queue.empty(); }
+
+  /**
+   * @brief 已编码未发送的周期数，含抢占后待跳过的旧帧
+   */
+  uint64_t Buffered() const {
+    return produced.load(std::memory_order_acquire) -
+           consumed.load(std::memory_order_acquire);
+  }
+
+  uint64_t Underruns() const {
+    return underruns.load(std::memory_order_relaxed);
+  }
+
+  uint32_t Size() const { return static_cast<uint32_t>(axes.size()); }
+};
+
+} // namespace Motor
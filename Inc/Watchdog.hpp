@@ -0,0 +1,118 @@
+/**
+ * @file Watchdog.hpp
+ * @author KalecKKK
+ * @brief 控制环看门狗：心跳超时后由看门狗线程持续发送安全设定值
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 控制线程卡住（缺页、嵌入运行时的 GC、调试器）时，电机会一直执行最后一条命令。
+ * 控制环每周期调用 Heartbeat，只写一个原子变量；看门狗线程睡到最近一次心跳加
+ * deadline 的时刻，心跳仍未更新即接管发送，每 safe_period 直接在后端上发送一批
+ * 零电流或制动帧，直到心跳恢复。安全设定值帧在 Add 时编码好，接管期间看门狗线程
+ * 不访问电机对象与遥测，控制线程停在任何调用中途都不冲突；每次发送前重新检查心跳。
+ * 每次超时记录开始、最后心跳与恢复的时刻。
+ *
+ *   Motor::Watchdog watchdog(can_transport, std::chrono::milliseconds(2));
+ *   watchdog.Add(motor, {.action = Motor::ACTION_BRAKE});
+ *   // 控制环每周期
+ *   watchdog.Heartbeat();
+ *
+ * 接管期间看门狗线程与控制线程可能同时调用后端的 Transmit，
+ * 后端须支持多线程发送，或给看门狗单独的通道句柄。
+ */
+
+#pragma once
+
+#include "Fault_monitor.hpp"
+#include "Motor_control.hpp"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace Motor {
+
+/**
+ * @brief 一次心跳超时，时刻均为 CLOCK_MONOTONIC，单位 ns
+ */
+struct Overrun_record {
+  uint64_t last_heartbeat;
+  uint64_t detected; // 看门狗接管的时刻
+  uint64_t resumed;  // 心跳恢复的时刻，仍在超时中为 0
+  uint32_t batches;  // 接管期间发送的安全设定值批数
+};
+
+class Watchdog {
+public:
+  static constexpr uint32_t HISTORY_SIZE = 64;
+
+protected:
+  EcanVci::Can_backend_handle backend;
+  uint64_t deadline, safe_period;
+  // 安全设定值帧在 Add 中编码好，接管时只发送，不访问电机与遥测
+  std::vector<CAN_OBJ> safe_frames;
+
+  alignas(64) std::atomic<uint64_t> heartbeat;
+  std::atomic<bool> tripped;
+  std::atomic<bool> running;
+
+  mutable std::mutex history_mutex;
+  std::deque<Overrun_record> history;
+  uint64_t overruns;
+
+  std::thread thread;
+
+  void Loop();
+  // 心跳未恢复前持续发送安全设定值，返回发送的批数
+  uint32_t TakeOver(uint64_t last_heartbeat);
+
+public:
+  /**
+   * @brief 启动看门狗线程，首次 Heartbeat 后开始计时
+   * @param backend 发送后端，须比本对象活得久
+   * @param deadline 两次心跳的最长间隔
+   * @param safe_period 接管期间发送安全设定值的周期，为 0 时取 deadline
+   */
+  Watchdog(EcanVci::Can_backend_handle backend,
+           std::chrono::nanoseconds deadline,
+           std::chrono::nanoseconds safe_period = std::chrono::nanoseconds(0));
+
+  ~Watchdog();
+
+  Watchdog(const Watchdog &) = delete;
+  Watchdog &operator=(const Watchdog &) = delete;
+
+  /**
+   * @brief 加入一个电机，超时时发送 safe 对应的设定值
+   * @note 首次 Heartbeat 之后加入，safe.action 为 ACTION_NONE 或
+   *       safe.ack_status 超过 ACK_TYPE_3 时抛出 std::runtime_error
+   */
+  void Add(const Motor_core &motor, const Fault_reaction &safe = {});
+
+  /**
+   * @brief 控制环每周期调用
+   */
+  void Heartbeat();
+
+  /**
+   * @brief 当前是否由看门狗接管
+   */
+  bool Tripped() const { return tripped.load(std::memory_order_acquire); }
+
+  /**
+   * @brief 累计超时次数
+   */
+  uint64_t Overruns() const;
+
+  /**
+   * @brief 最近 HISTORY_SIZE 次超时，按时间顺序
+   */
+  std::vector<Overrun_record> History() const;
+};
+
+} // namespace Motor
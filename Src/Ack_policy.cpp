@@ -0,0 +1,74 @@
+/**
+ * @file Ack_policy.cpp
+ * @brief 实现 Ack_policy.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Ack_policy.hpp"
+#include "Logger.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace Motor {
+
+Ack_policy::Ack_policy(uint32_t interval, Message_return_status ack_type)
+    : interval(interval), ack_type(ack_type),
+      tracking_threshold(std::numeric_limits<float>::infinity()),
+      temperature_threshold(std::numeric_limits<int>::max()),
+      temperature_window(0), cycle(0), last_ack_cycle(0), ack_count(0),
+      fault(false), temperature_rising(false), has_temperature(false),
+      reference_temperature(0), reference_cycle(0) {
+  if (interval == 0 || ack_type == NO_ACK) {
+    throw std::invalid_argument("Invalid ack policy");
+  }
+}
+
+void Ack_policy::SetTrackingThreshold(float threshold) {
+  tracking_threshold = threshold;
+}
+
+void Ack_policy::SetTemperatureThreshold(int threshold, uint32_t window) {
+  temperature_threshold = threshold;
+  temperature_window = window;
+}
+
+Message_return_status Ack_policy::Next(float tracking_error) {
+  cycle++;
+  // 第一个周期总是请求应答，以获得初始状态
+  bool due = ack_count == 0 || cycle - last_ack_cycle >= interval ||
+             std::fabs(tracking_error) > tracking_threshold || fault ||
+             temperature_rising;
+  if (!due) {
+    return NO_ACK;
+  }
+  last_ack_cycle = cycle;
+  ack_count++;
+  return ack_type;
+}
+
+void Ack_policy::Observe(const Motor_control::Motor_info &info) {
+  if ((info.error_code != NO_ERROR) != fault) {
+    fault = info.error_code != NO_ERROR;
+    LOG_EVERY(Log::WARN, 1000, "Motor {} error code {}, ack every cycle: {}",
+              info.motor_id, static_cast<int>(info.error_code), fault);
+  }
+
+  if (!has_temperature) {
+    has_temperature = true;
+    reference_temperature = info.motor_temperature;
+    reference_cycle = cycle;
+    return;
+  }
+  temperature_rising =
+      info.motor_temperature - reference_temperature >= temperature_threshold;
+  // 参考点按窗口滑动，温升放缓后自动回到稀疏应答
+  if (cycle - reference_cycle >= temperature_window) {
+    reference_temperature = info.motor_temperature;
+    reference_cycle = cycle;
+  }
+}
+
+} // namespace Motor
@@ -0,0 +1,104 @@
+/**
+ * @file Bus_budget.cpp
+ * @brief 实现 Bus_budget.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Bus_budget.hpp"
+#include "Logger.hpp"
+#include <stdexcept>
+
+namespace EcanVci {
+
+static_assert(Bus_budget::Bitrate(TIM0_KBPS_1000, TIM1_KBPS_1000) == 1000000);
+static_assert(Bus_budget::Bitrate(TIM0_KBPS_500, TIM1_KBPS_500) == 500000);
+static_assert(Bus_budget::Bitrate(TIM0_KBPS_5, TIM1_KBPS_5) == 5000);
+static_assert(Bus_budget::FrameBits(8) == 135);
+static_assert(Bus_budget::FrameBits(8, true) == 160);
+
+Bus_budget::Bus_budget(uint32_t bitrate, double target_utilization)
+    : bitrate(bitrate), target_utilization(target_utilization) {
+  if (bitrate == 0 || target_utilization <= 0) {
+    throw std::invalid_argument("Invalid bus budget");
+  }
+}
+
+Bus_budget::Bus_budget(const Can_transport &transport,
+                       double target_utilization)
+    : Bus_budget(transport.Bitrate(), target_utilization) {}
+
+double Bus_budget::FrameTime(uint8_t data_len, bool extended) const {
+  return FrameBits(data_len, extended) * 1e6 / bitrate;
+}
+
+void Bus_budget::AddExchange(const char *label, uint8_t request_len,
+                             uint8_t reply_len, double rate_hz, uint32_t count,
+                             bool extended) {
+  if (request_len > 8 || reply_len > 8) {
+    throw std::invalid_argument("Data length should be less than or equal to 8");
+  }
+  entries.push_back(
+      {label, request_len, reply_len, extended, rate_hz, count});
+}
+
+void Bus_budget::Clear() { entries.clear(); }
+
+namespace {
+
+double ExchangeBits(uint8_t request_len, uint8_t reply_len, bool extended) {
+  double bits = Bus_budget::FrameBits(request_len, extended);
+  if (reply_len > 0) {
+    bits += Bus_budget::FrameBits(reply_len, extended);
+  }
+  return bits;
+}
+
+} // namespace
+
+double Bus_budget::Utilization() const {
+  double bits = 0;
+  for (const Bus_load_entry &entry : entries) {
+    bits += ExchangeBits(entry.request_len, entry.reply_len, entry.extended) *
+            entry.rate_hz * entry.count;
+  }
+  return bits / bitrate;
+}
+
+uint32_t Bus_budget::Headroom(uint8_t request_len, uint8_t reply_len,
+                              double rate_hz, bool extended) const {
+  double free = (target_utilization - Utilization()) * bitrate;
+  double bits = ExchangeBits(request_len, reply_len, extended) * rate_hz;
+  if (free <= 0 || bits <= 0) {
+    return 0;
+  }
+  return static_cast<uint32_t>(free / bits);
+}
+
+DWORD Bus_budget::Check(Budget_policy policy) const {
+  double utilization = Utilization();
+  if (utilization <= target_utilization) {
+    LOG_INFO("Bus utilization {}% of {} bit/s", utilization * 100, bitrate);
+    return STATUS_OK;
+  }
+  LOG_WARN("Bus utilization {}% exceeds target {}% at {} bit/s",
+           utilization * 100, target_utilization * 100, bitrate);
+  Report();
+  if (policy == BUDGET_REJECT) {
+    throw std::runtime_error("Bus utilization exceeds target");
+  }
+  return STATUS_ERR;
+}
+
+void Bus_budget::Report() const {
+  for (const Bus_load_entry &entry : entries) {
+    double bits =
+        ExchangeBits(entry.request_len, entry.reply_len, entry.extended);
+    LOG_INFO("  {}: {} x {} Hz, {} us per exchange, {}%", entry.label,
+             entry.count, entry.rate_hz, bits * 1e6 / bitrate,
+             bits * entry.rate_hz * entry.count * 100 / bitrate);
+  }
+}
+
+} // namespace EcanVci
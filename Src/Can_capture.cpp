@@ -0,0 +1,245 @@
+/**
+ * @file Can_capture.cpp
+ * @brief 实现 Can_capture.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Can_capture.hpp"
+#include <chrono>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace EcanVci {
+
+namespace {
+
+constexpr uint32_t CAPTURE_MAGIC = 0x50414343; // "CCAP"
+constexpr uint16_t CAPTURE_VERSION = 1;
+
+uint64_t Now(clockid_t clock) {
+  timespec now;
+  clock_gettime(clock, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+uint64_t RoundUpPow2(uint64_t value) {
+  uint64_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+} // namespace
+
+Can_capture::Can_capture(const std::string &path, uint64_t capacity) {
+  capacity = RoundUpPow2(capacity < 2 ? 2 : capacity);
+  mask = capacity - 1;
+  mapped_size = sizeof(Capture_header) + capacity * sizeof(Capture_record);
+
+  fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Open capture file failed");
+  }
+
+  struct stat st;
+  bool reuse = fstat(fd, &st) == 0 &&
+               static_cast<size_t>(st.st_size) == mapped_size;
+  if (!reuse && ftruncate(fd, mapped_size) != 0) {
+    close(fd);
+    throw std::runtime_error("Resize capture file failed");
+  }
+
+  void *base =
+      mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    close(fd);
+    throw std::runtime_error("Map capture file failed");
+  }
+  header = static_cast<Capture_header *>(base);
+  records = reinterpret_cast<Capture_record *>(header + 1);
+
+  if (!reuse || header->magic != CAPTURE_MAGIC ||
+      header->version != CAPTURE_VERSION ||
+      header->record_size != sizeof(Capture_record) ||
+      header->capacity != capacity) {
+    memset(base, 0, mapped_size);
+    header->version = CAPTURE_VERSION;
+    header->record_size = sizeof(Capture_record);
+    header->capacity = capacity;
+    header->write_index.store(0, std::memory_order_relaxed);
+    header->start_monotonic = Now(CLOCK_MONOTONIC);
+    header->start_realtime = Now(CLOCK_REALTIME);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = CAPTURE_MAGIC;
+  }
+}
+
+Can_capture::~Can_capture() {
+  munmap(header, mapped_size);
+  close(fd);
+}
+
+uint64_t Can_capture::Count() const {
+  return header->write_index.load(std::memory_order_acquire);
+}
+
+Can_replay::Can_replay(const std::string &path, Replay_speed speed,
+                       int channel)
+    : speed(speed), channel(channel), transmitted(0), mismatched(0) {
+  fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Open capture file failed");
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(Capture_header)) {
+    close(fd);
+    throw std::runtime_error("Capture file too small");
+  }
+  mapped_size = st.st_size;
+
+  void *base = mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    close(fd);
+    throw std::runtime_error("Map capture file failed");
+  }
+  header = static_cast<const Capture_header *>(base);
+  records = reinterpret_cast<const Capture_record *>(header + 1);
+
+  if (header->magic != CAPTURE_MAGIC || header->version != CAPTURE_VERSION ||
+      header->record_size != sizeof(Capture_record) ||
+      (header->capacity & (header->capacity - 1)) != 0 ||
+      sizeof(Capture_header) + header->capacity * sizeof(Capture_record) !=
+          mapped_size) {
+    munmap(base, mapped_size);
+    close(fd);
+    throw std::runtime_error("Invalid capture file");
+  }
+  mask = header->capacity - 1;
+
+  Rewind();
+}
+
+Can_replay::~Can_replay() {
+  munmap(const_cast<Capture_header *>(header), mapped_size);
+  close(fd);
+}
+
+bool Can_replay::Load(uint64_t index, Capture_record &record) const {
+  const Capture_record &slot = records[index & mask];
+  std::atomic_ref<const uint32_t> sequence(slot.sequence);
+  if (sequence.load(std::memory_order_acquire) !=
+      static_cast<uint32_t>(index) + 1) {
+    return false;
+  }
+  record = slot;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return sequence.load(std::memory_order_relaxed) ==
+         static_cast<uint32_t>(index) + 1;
+}
+
+bool Can_replay::Match(const Capture_record &record) const {
+  return channel < 0 || record.channel == channel;
+}
+
+void Can_replay::Rewind() {
+  end = header->write_index.load(std::memory_order_acquire);
+  begin = end > header->capacity ? end - header->capacity : 0;
+  cursor = tx_cursor = begin;
+
+  first_timestamp = 0;
+  Capture_record record;
+  for (uint64_t i = begin; i < end; i++) {
+    if (Load(i, record)) {
+      first_timestamp = record.host_timestamp;
+      break;
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &start_time);
+}
+
+bool Can_replay::Finished() const { return cursor >= end; }
+
+DWORD Can_replay::Receive(CAN_OBJ msgs[], ULONG len, INT wait_time) {
+  Capture_record record;
+
+  // 跳过发送记录、其他通道与损坏的记录
+  while (cursor < end) {
+    if (Load(cursor, record) && Match(record) && (record.flags & CAPTURE_RX)) {
+      break;
+    }
+    cursor++;
+  }
+  if (cursor >= end) {
+    return 0;
+  }
+
+  if (speed == REPLAY_ORIGINAL_SPEED) {
+    uint64_t due = Now(CLOCK_MONOTONIC) -
+                   (static_cast<uint64_t>(start_time.tv_sec) * 1000000000ULL +
+                    start_time.tv_nsec);
+    uint64_t offset = record.host_timestamp - first_timestamp;
+    if (offset > due) {
+      uint64_t wait_ns = static_cast<uint64_t>(wait_time) * 1000000ULL;
+      if (offset - due > wait_ns) {
+        if (wait_time > 0) {
+          std::this_thread::sleep_for(std::chrono::nanoseconds(wait_ns));
+        }
+        return 0;
+      }
+      std::this_thread::sleep_for(std::chrono::nanoseconds(offset - due));
+    }
+  }
+
+  ULONG count = 0;
+  while (cursor < end && count < len) {
+    if (!Load(cursor, record) || !Match(record)) {
+      cursor++;
+      continue;
+    }
+    if (!(record.flags & CAPTURE_RX)) {
+      break;
+    }
+    CAN_OBJ &msg = msgs[count++];
+    memset(&msg, 0, sizeof(msg));
+    msg.ID = record.id;
+    msg.TimeStamp = record.device_timestamp;
+    msg.TimeFlag = (record.flags & CAPTURE_TIME) ? 1 : 0;
+    msg.RemoteFlag = (record.flags & CAPTURE_REMOTE) ? 1 : 0;
+    msg.ExternFlag = (record.flags & CAPTURE_EXTERN) ? 1 : 0;
+    msg.DataLen = record.data_len;
+    memcpy(msg.Data, record.data, 8);
+    cursor++;
+  }
+  return count;
+}
+
+DWORD Can_replay::Transmit(const CAN_OBJ msgs[], ULONG len) {
+  Capture_record record;
+  for (ULONG i = 0; i < len; i++) {
+    while (tx_cursor < end && !(Load(tx_cursor, record) && Match(record) &&
+                                !(record.flags & CAPTURE_RX))) {
+      tx_cursor++;
+    }
+    if (tx_cursor >= end || record.id != msgs[i].ID ||
+        record.data_len != msgs[i].DataLen ||
+        memcmp(record.data, msgs[i].Data, msgs[i].DataLen) != 0) {
+      mismatched++;
+    }
+    if (tx_cursor < end) {
+      tx_cursor++;
+    }
+    transmitted++;
+  }
+  return len;
+}
+
+} // namespace EcanVci
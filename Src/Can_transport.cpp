@@ -1,10 +1,107 @@
 #include "Can_transport.hpp"
+#include "Bus_budget.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
 #include <chrono>
 #include <cstring>
-#include <iostream>
+#include <future>
+#include <map>
+#include <mutex>
 #include <stdexcept>
 #include <thread>
 
+static_assert(EcanVci::Can_backend<EcanVci::Can_transport>);
+
+namespace {
+
+using std::chrono::milliseconds;
+
+constexpr milliseconds BACKOFF_INITIAL{1};
+constexpr milliseconds BACKOFF_MAX{64};
+constexpr milliseconds OPEN_TIMEOUT{3000};
+constexpr milliseconds READY_TIMEOUT{100};
+
+/**
+ * @brief 以指数退避重复探测直到成功或超时
+ */
+template <typename Probe> bool Retry(Probe probe, milliseconds timeout) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  milliseconds backoff = BACKOFF_INITIAL;
+  while (!probe()) {
+    if (std::chrono::steady_clock::now() + backoff > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(backoff);
+    backoff = std::min(backoff * 2, BACKOFF_MAX);
+  }
+  return true;
+}
+
+// 同一适配器上的多个通道共用一次 OpenDevice，最后一个通道析构时关闭
+struct Device {
+  std::mutex mutex;
+  uint32_t references = 0;
+};
+
+struct Device_registry {
+  std::mutex mutex;
+  std::map<std::pair<DWORD, DWORD>, Device> devices;
+};
+
+Device_registry &Registry() {
+  static Device_registry registry;
+  return registry;
+}
+
+Device &GetDevice(DWORD device_type, DWORD device_index) {
+  Device_registry &registry = Registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  // std::map 的节点地址在插入后不变
+  return registry.devices[{device_type, device_index}];
+}
+
+void AcquireDevice(DWORD device_type, DWORD device_index) {
+  Device &device = GetDevice(device_type, device_index);
+  std::lock_guard<std::mutex> lock(device.mutex);
+  if (device.references > 0) {
+    device.references++;
+    return;
+  }
+
+  if (!Retry(
+          [&] { return OpenDevice(device_type, device_index, 0) == STATUS_OK; },
+          OPEN_TIMEOUT)) {
+    LOG_ERROR("OpenDevice {}:{} failed", device_type, device_index);
+    throw std::runtime_error("OpenDevice failed");
+  }
+  // 能读出板卡信息说明设备已就绪
+  BOARD_INFO info;
+  if (!Retry(
+          [&] {
+            return ReadBoardInfo(device_type, device_index, &info) == STATUS_OK;
+          },
+          READY_TIMEOUT)) {
+    CloseDevice(device_type, device_index);
+    LOG_ERROR("Device {}:{} not ready", device_type, device_index);
+    throw std::runtime_error("Device not ready");
+  }
+  LOG_INFO("OpenDevice {}:{} succeeded, firmware {:x}", device_type,
+           device_index, info.fw_Version);
+  device.references = 1;
+}
+
+void ReleaseDevice(DWORD device_type, DWORD device_index) {
+  Device &device = GetDevice(device_type, device_index);
+  std::lock_guard<std::mutex> lock(device.mutex);
+  if (device.references > 0 && --device.references == 0) {
+    CloseDevice(device_type, device_index);
+    LOG_INFO("CloseDevice {}:{}", device_type, device_index);
+  }
+}
+
+} // namespace
+
 EcanVci::Can_transport::Can_transport()
     : Can_transport(0x04, 0x00, CAN_ID::CAN_1) {}
 
@@ -12,53 +109,155 @@ EcanVci::Can_transport::Can_transport(CAN_ID can_index)
     : Can_transport(0x04, 0x00, can_index) {}
 
 EcanVci::Can_transport::Can_transport(DWORD device_type, DWORD device_index,
-                                      CAN_ID can_index) {
+                                      CAN_ID can_index, Tim0Kbps timing0,
+                                      Tim1Kbps timing1)
+    : timing0(timing0), timing1(timing1), capture(nullptr), replay(nullptr) {
   this->device_type = device_type;
   this->device_index = device_index;
+  this->can_index = can_index;
 
-  int try_times = 0;
-  while (!OpenDevice(device_type, device_index, 0) && try_times < 3) {
-    std::cerr << "OpenDevice failed, try again\n";
-    try_times++;
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+  AcquireDevice(device_type, device_index);
+  try {
+    INIT_CONFIG config{};
+    config.AccCode = 0;
+    config.AccMask = 0xFFFFFFFF;
+    config.Filter = 0;
+    config.Mode = 0;
+    config.Timing0 = timing0;
+    config.Timing1 = timing1;
+    if (!InitCAN(device_type, device_index, static_cast<DWORD>(can_index),
+                 &config)) {
+      LOG_ERROR("InitCAN failed");
+      throw std::runtime_error("InitCAN failed");
+    }
+    if (!StartCAN(device_type, device_index, static_cast<DWORD>(can_index))) {
+      LOG_ERROR("StartCAN failed");
+      throw std::runtime_error("StartCAN failed");
+    }
+    // 控制器能读出状态即可收发，不再固定等待
+    CAN_STATUS status;
+    if (!Retry(
+            [&] {
+              return ReadCANStatus(device_type, device_index,
+                                   static_cast<DWORD>(can_index),
+                                   &status) == STATUS_OK;
+            },
+            READY_TIMEOUT)) {
+      LOG_ERROR("CAN {} not ready", can_index);
+      throw std::runtime_error("CAN not ready");
+    }
+  } catch (...) {
+    ReleaseDevice(device_type, device_index);
+    throw;
   }
-  if (try_times == 3) {
-    std::cerr << "OpenDevice failed\n";
-    throw std::runtime_error("OpenDevice failed");
+  LOG_INFO("CAN {} started", can_index);
+}
+
+std::vector<std::unique_ptr<EcanVci::Can_transport>>
+EcanVci::Can_transport::OpenAll(const std::vector<Channel_config> &configs) {
+  // 每个通道一个线程，同一适配器的打开由设备表串行化
+  std::vector<std::future<std::unique_ptr<Can_transport>>> futures;
+  futures.reserve(configs.size());
+  for (const Channel_config &config : configs) {
+    futures.push_back(std::async(std::launch::async, [config] {
+      return std::make_unique<Can_transport>(
+          config.device_type, config.device_index, config.can_index,
+          config.timing0, config.timing1);
+    }));
   }
-  std::cout << "OpenDevice succeeded\n";
 
-  INIT_CONFIG config = {0};
-  config.AccCode = 0;
-  config.AccMask = 0xFFFFFFFF;
-  config.Filter = 0;
-  config.Mode = 0;
-  config.Timing0 = TIM0_KBPS_1000;
-  config.Timing1 = TIM1_KBPS_1000;
-  if (!InitCAN(device_type, device_index, static_cast<DWORD>(can_index),
-               &config)) {
-    std::cerr << "InitCAN failed\n";
-    throw std::runtime_error("InitCAN failed");
+  // 先等待全部结束，失败时已打开的通道随 transports 析构关闭
+  std::vector<std::unique_ptr<Can_transport>> transports;
+  std::exception_ptr exception;
+  for (auto &future : futures) {
+    try {
+      transports.push_back(future.get());
+    } catch (...) {
+      if (!exception) {
+        exception = std::current_exception();
+      }
+    }
   }
-  std::cout << "InitCAN " << can_index << " succeeded\n";
-  StartCAN(device_type, device_index, static_cast<DWORD>(can_index));
-  std::cout << "StartCAN " << can_index << " succeeded\n";
-  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  if (exception) {
+    std::rethrow_exception(exception);
+  }
+  return transports;
 }
 
+EcanVci::Can_transport::Can_transport(Can_replay &replay, CAN_ID can_index)
+    : device_type(0), device_index(0), can_index(can_index),
+      timing0(TIM0_KBPS_1000), timing1(TIM1_KBPS_1000), capture(nullptr),
+      replay(&replay) {}
+
 EcanVci::Can_transport::~Can_transport() {
-  CloseDevice(device_type, device_index);
-  std::cout << "CloseDevice\n";
+  if (replay) {
+    return;
+  }
+  ReleaseDevice(device_type, device_index);
+}
+
+uint32_t EcanVci::Can_transport::Bitrate() const {
+  return Bus_budget::Bitrate(timing0, timing1);
+}
+
+void EcanVci::Can_transport::AttachCapture(const Can_capture *capture) {
+  this->capture = capture;
+}
+
+DWORD EcanVci::Can_transport::Transmit(CAN_OBJ msgs[], ULONG len) const {
+  DWORD result;
+  if (replay) {
+    result = replay->Transmit(msgs, len);
+  } else {
+    MOTOR_PROFILE_SCOPE(PHASE_TRANSMIT);
+    result = ::Transmit(device_type, device_index,
+                        static_cast<DWORD>(can_index), msgs, len);
+  }
+  if (capture && result > 0 && result <= len) {
+    capture->Record(0, Channel(), msgs, result);
+  }
+  return result;
+}
+
+DWORD EcanVci::Can_transport::Receive(CAN_OBJ msgs[], ULONG len,
+                                      INT wait_time) const {
+  DWORD result;
+  if (replay) {
+    result = replay->Receive(msgs, len, wait_time);
+  } else {
+    MOTOR_PROFILE_SCOPE(PHASE_RECEIVE);
+    result = ::Receive(device_type, device_index,
+                       static_cast<DWORD>(can_index), msgs, len, wait_time);
+  }
+  // 失败时驱动返回 0xFFFFFFFF
+  if (static_cast<INT>(result) <= 0) {
+    return 0;
+  }
+  if (capture) {
+    capture->Record(CAPTURE_RX, Channel(), msgs, result);
+  }
+  return result;
+}
+
+DWORD EcanVci::Can_transport::ReadError(ERR_INFO &error) const {
+  error = {};
+  if (replay) {
+    return STATUS_OK;
+  }
+  return ReadErrInfo(device_type, device_index, static_cast<DWORD>(can_index),
+                     &error) == STATUS_OK
+             ? STATUS_OK
+             : STATUS_ERR;
 }
 
 DWORD EcanVci::Can_transport::Transmit(UINT destination, BYTE data[],
                                        ULONG len) const {
   if (len > 8) {
-    std::cerr << "Data length should be less than or equal to 8\n";
+    LOG_ERROR("Data length should be less than or equal to 8");
     throw std::runtime_error("Data length should be less than or equal to 8");
   }
 
-  CAN_OBJ msg = {0};
+  CAN_OBJ msg{};
   msg.ID = destination;
   msg.DataLen = static_cast<BYTE>(len);
   memcpy(msg.Data, data, len);
@@ -76,10 +275,9 @@ DWORD EcanVci::Can_transport::Transmit(UINT destination, BYTE data[],
   std::cout << std::dec << std::endl;
   //*/
 
-  auto result = ::Transmit(device_type, device_index,
-                           static_cast<DWORD>(can_index), &msg, 1);
+  auto result = Transmit(&msg, 1);
   if (result != 1) {
-    std::cerr << "Transmit failed\n";
+    LOG_ERROR("Transmit failed");
     throw std ::runtime_error("Transmit failed");
   }
   return result;
@@ -88,9 +286,8 @@ DWORD EcanVci::Can_transport::Transmit(UINT destination, BYTE data[],
 DWORD EcanVci::Can_transport::ReceiveOnce(UINT &source, BYTE data[], ULONG &len,
                                           ULONG wait_time) const {
   CAN_OBJ msg;
-  auto result = ::Receive(device_type, device_index,
-                          static_cast<DWORD>(can_index), &msg, 1, wait_time);
-  if (result <= 0) {
+  auto result = Receive(&msg, 1, wait_time);
+  if (result == 0) {
     return STATUS_ERR;
   }
 
@@ -104,9 +301,8 @@ DWORD EcanVci::Can_transport::ReceiveOnce(UINT &source, BYTE data[], ULONG &len,
 DWORD EcanVci::Can_transport::ReceiveLast(UINT &source, BYTE data[], ULONG &len,
                                           ULONG wait_time) const {
   CAN_OBJ msg[100];
-  auto result = ::Receive(device_type, device_index,
-                          static_cast<DWORD>(can_index), msg, 100, wait_time);
-  if (result <= 0) {
+  auto result = Receive(msg, 100, wait_time);
+  if (result == 0) {
     return STATUS_ERR;
   }
 
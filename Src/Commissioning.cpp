@@ -0,0 +1,131 @@
+/**
+ * @file Commissioning.cpp
+ * @brief 实现 Commissioning.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Commissioning.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Motor {
+
+Commissioning::Commissioning(Async_executor &executor) : executor(executor) {}
+
+void Commissioning::Add(Motor_core &motor, const Commission_plan &plan) {
+  // 重置后电机以 ID 1 应答
+  uint16_t from_id = plan.reset_id ? 0x01 : plan.from_id.value_or(motor.ID());
+  for (const Entry &entry : entries) {
+    if (entry.motor == &motor) {
+      throw std::runtime_error("Motor already added");
+    }
+    // 重置 ID 是广播（0x7F7F），总线上的每个电机都会执行
+    if (plan.reset_id || entry.plan.reset_id) {
+      throw std::runtime_error("Reset ID requires a single motor on the bus");
+    }
+    uint16_t other = entry.plan.reset_id
+                         ? 0x01
+                         : entry.plan.from_id.value_or(entry.motor->ID());
+    if (other == from_id) {
+      throw std::runtime_error("Motors share the same current ID");
+    }
+  }
+  entries.push_back({&motor, plan, {motor.ID(), STEP_RESET_ID, {}}});
+}
+
+const char *Commissioning::StepName(Commission_step step) {
+  switch (step) {
+  case STEP_RESET_ID:
+    return "reset ID";
+  case STEP_ASSIGN_ID:
+    return "assign ID";
+  case STEP_SET_ZERO:
+    return "set zero";
+  case STEP_SET_MODE:
+    return "set mode";
+  case STEP_VERIFY:
+    return "verify";
+  default:
+    return "done";
+  }
+}
+
+Task<void> Commissioning::Commission(Entry &entry) {
+  Motor_core &motor = *entry.motor;
+  const Commission_plan &plan = entry.plan;
+  Commission_result &result = entry.result;
+  auto start = std::chrono::steady_clock::now();
+  std::optional<uint16_t> from_id = plan.from_id;
+
+  // 每一步以反馈帧确认，失败时停在该步骤
+  result.step = STEP_RESET_ID;
+  if (plan.reset_id) {
+    if (co_await motor.ResetIDAsync() != STATUS_OK ||
+        co_await motor.QueryIDAsync() != std::optional<uint16_t>(0x01)) {
+      co_return;
+    }
+    from_id = 0x01;
+  }
+
+  result.step = STEP_ASSIGN_ID;
+  if (from_id && *from_id != motor.ID() &&
+      co_await motor.AssignIDAsync(*from_id) != STATUS_OK) {
+    co_return;
+  }
+
+  result.step = STEP_SET_ZERO;
+  if (plan.set_zero && co_await motor.SetZeroAsync() != STATUS_OK) {
+    co_return;
+  }
+
+  result.step = STEP_SET_MODE;
+  if (plan.mode != Communication_mode::UNKOWN &&
+      co_await motor.SetCommunicationModeAsync(plan.mode) != STATUS_OK) {
+    co_return;
+  }
+
+  // 以目标 ID 查询通信模式，确认电机在线且模式生效
+  result.step = STEP_VERIFY;
+  Communication_mode mode = co_await motor.QueryCommunicationModeAsync();
+  if (mode == Communication_mode::UNKOWN ||
+      (plan.mode != Communication_mode::UNKOWN && mode != plan.mode)) {
+    co_return;
+  }
+
+  result.step = STEP_DONE;
+  result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+void Commissioning::Schedule() {
+  for (Entry &entry : entries) {
+    entry.result = {entry.motor->ID(), STEP_RESET_ID, {}};
+    executor.Spawn(Commission(entry));
+  }
+}
+
+uint32_t Commissioning::Run() {
+  auto start = std::chrono::steady_clock::now();
+  Schedule();
+  executor.Run();
+
+  uint32_t failed = 0;
+  for (const Entry &entry : entries) {
+    if (entry.result.step != STEP_DONE) {
+      LOG_ERROR("Motor {} commissioning failed at {}", entry.result.motor_id,
+                StepName(entry.result.step));
+      failed++;
+    }
+  }
+  LOG_INFO("Commissioned {} motors in {} us, {} failed", entries.size(),
+           std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start)
+               .count(),
+           failed);
+  return failed;
+}
+
+} // namespace Motor
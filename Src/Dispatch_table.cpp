@@ -0,0 +1,68 @@
+/**
+ * @file Dispatch_table.cpp
+ * @brief 实现 Dispatch_table.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Dispatch_table.hpp"
+#include "Logger.hpp"
+#include "Motor_control.hpp"
+#include <algorithm>
+
+namespace Motor {
+
+Dispatch_table::Dispatch_table() { standard.fill({nullptr, 0}); }
+
+DWORD Dispatch_table::Register(Motor_core &motor, uint32_t slot,
+                               bool is_extended) {
+  UINT id = motor.ID();
+  if (!is_extended && id == MANAGEMENT_ID) {
+    LOG_ERROR("Motor ID {:x} is reserved for management frames", id);
+    return STATUS_ERR;
+  }
+  Entry *entry;
+  if (!is_extended && id < standard.size()) {
+    entry = &standard[id];
+  } else {
+    entry = &extended.try_emplace(id, Entry{nullptr, 0}).first->second;
+  }
+  if (entry->motor && entry->motor != &motor) {
+    LOG_ERROR("Motor ID {:x} registered twice", id);
+    return STATUS_ERR;
+  }
+  *entry = {&motor, slot};
+  return STATUS_OK;
+}
+
+void Dispatch_table::Unregister(const Motor_core &motor) {
+  for (Entry &entry : standard) {
+    if (entry.motor == &motor) {
+      entry = {nullptr, 0};
+    }
+  }
+  std::erase_if(extended,
+                [&](const auto &item) { return item.second.motor == &motor; });
+}
+
+size_t Dispatch_table::Size() const {
+  return extended.size() +
+         std::count_if(standard.begin(), standard.end(),
+                       [](const Entry &entry) { return entry.motor; });
+}
+
+std::vector<uint16_t> Dispatch_table::FilterIds() const {
+  std::vector<uint16_t> ids;
+  if (!extended.empty()) {
+    return ids;
+  }
+  for (size_t id = 0; id < standard.size(); id++) {
+    if (standard[id].motor) {
+      ids.push_back(static_cast<uint16_t>(id));
+    }
+  }
+  return ids;
+}
+
+} // namespace Motor
@@ -0,0 +1,137 @@
+/**
+ * @file Estimator_bank.cpp
+ * @brief 实现 Estimator_bank.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Estimator_bank.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Motor {
+
+Estimator_config Estimator_config::FromNoise(float acceleration_noise,
+                                             float position_noise,
+                                             float period) {
+  if (acceleration_noise <= 0 || position_noise <= 0 || period <= 0) {
+    throw std::runtime_error("Estimator noise and period must be positive");
+  }
+  // Kalata, "The Tracking Index", IEEE TAES 1984
+  double lambda = acceleration_noise * period * period / position_noise;
+  double root = std::sqrt(lambda * lambda + 8 * lambda);
+  double alpha = -(lambda * lambda + 8 * lambda - (lambda + 4) * root) / 8;
+  double beta = (lambda * lambda + 4 * lambda - lambda * root) / 4;
+  return {static_cast<float>(alpha), static_cast<float>(beta)};
+}
+
+Estimator_bank::Estimator_bank()
+    : axes(std::make_unique<Axes>()), latest(0), resets(0) {
+  axis_of.fill(NO_AXIS);
+  motor_ids.reserve(ESTIMATOR_SIZE);
+}
+
+uint32_t Estimator_bank::Add(const Motor_core &motor,
+                             const Estimator_config &config) {
+  if (motor_ids.size() >= ESTIMATOR_SIZE) {
+    throw std::runtime_error("Estimator bank is full");
+  }
+  if (motor.ID() >= axis_of.size() || axis_of[motor.ID()] != NO_AXIS) {
+    LOG_ERROR("Motor ID {:x} invalid or already in estimator", motor.ID());
+    throw std::runtime_error("Motor already in estimator");
+  }
+  uint32_t axis = Size();
+  motor_ids.push_back(motor.ID());
+  reset_gap.push_back(0.0f);
+  timestamp.push_back(0);
+  measured_at.push_back(0);
+  axis_of[motor.ID()] = static_cast<uint16_t>(axis);
+
+  SetConfig(axis, config);
+  axes->position[axis] = motor.motor_info.position;
+  axes->speed[axis] = 0.0f;
+  axes->predicted_position[axis] = motor.motor_info.position;
+  axes->measured_position[axis] = 0.0f;
+  axes->measured_speed[axis] = 0.0f;
+  return axis;
+}
+
+void Estimator_bank::SetConfig(uint32_t axis, const Estimator_config &config) {
+  axes->alpha[axis] = config.alpha;
+  axes->beta[axis] = config.beta;
+  axes->speed_weight[axis] = config.speed_weight;
+  reset_gap[axis] = config.reset_gap;
+}
+
+void Estimator_bank::Reset(uint32_t axis) { timestamp.at(axis) = 0; }
+
+uint32_t Estimator_bank::Update(const Feedback_batch &batch) {
+  Axes &a = *axes;
+  uint32_t len = Size();
+  std::fill_n(a.dt, len, 0.0f);
+  std::fill_n(a.position_gain, len, 0.0f);
+  std::fill_n(a.speed_gain, len, 0.0f);
+  std::fill_n(a.weight, len, 0.0f);
+  std::fill(measured_at.begin(), measured_at.end(), 0);
+
+  uint32_t updated = 0;
+  for (uint32_t i = 0; i < batch.count; i++) {
+    uint16_t axis = Axis(batch.motor_id[i]);
+    uint64_t at = batch.timestamp[i];
+    if (axis == NO_AXIS || at == 0 || at <= timestamp[axis] ||
+        at <= measured_at[axis]) {
+      continue;
+    }
+    if (measured_at[axis] == 0) {
+      updated++;
+    }
+    measured_at[axis] = at;
+    latest = std::max(latest, at);
+
+    float gap = static_cast<float>(at - timestamp[axis]) * 1e-6f;
+    if (timestamp[axis] == 0 || gap > reset_gap[axis]) {
+      // 首次反馈或中断过久，旧估计已无意义
+      a.position[axis] = batch.position[i];
+      a.speed[axis] = batch.speed[i];
+      a.dt[axis] = a.position_gain[axis] = a.speed_gain[axis] =
+          a.weight[axis] = 0.0f;
+      timestamp[axis] = at;
+      resets++;
+      continue;
+    }
+    a.measured_position[axis] = batch.position[i];
+    a.measured_speed[axis] = batch.speed[i];
+    a.dt[axis] = gap;
+    a.position_gain[axis] = a.alpha[axis];
+    a.speed_gain[axis] = a.beta[axis] / gap;
+    a.weight[axis] = a.speed_weight[axis];
+  }
+
+  Simd::AlphaBeta({a.measured_position, a.measured_speed, a.dt,
+                   a.position_gain, a.speed_gain, a.weight, a.position,
+                   a.speed},
+                  len);
+  for (uint32_t axis = 0; axis < len; axis++) {
+    if (measured_at[axis]) {
+      timestamp[axis] = measured_at[axis];
+    }
+  }
+  return updated;
+}
+
+void Estimator_bank::Predict(uint64_t timestamp) {
+  Axes &a = *axes;
+  uint32_t len = Size();
+  for (uint32_t axis = 0; axis < len; axis++) {
+    uint64_t from = this->timestamp[axis];
+    a.lead[axis] = from && timestamp > from
+                       ? static_cast<float>(timestamp - from) * 1e-6f
+                       : 0.0f;
+  }
+  Simd::Extrapolate(a.position, a.speed, a.lead, a.predicted_position, len);
+}
+
+} // namespace Motor
@@ -0,0 +1,221 @@
+/**
+ * @file Fault_monitor.cpp
+ * @brief 实现 Fault_monitor.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Fault_monitor.hpp"
+#include "Logger.hpp"
+#include <stdexcept>
+#include <utility>
+
+namespace Motor {
+
+Fault_monitor::Fault_monitor(std::chrono::nanoseconds period)
+    : period(period),
+      queue(std::make_unique<Spsc_ring<Fault_event, FAULT_QUEUE_SIZE>>()),
+      scratch(1), staged(0), active(0), dropped(0), reactions(0),
+      over_budget(0), max_latency(0), total_latency(0) {
+  slot_of.fill(NO_SLOT);
+  queue->Reset();
+}
+
+uint32_t Fault_monitor::Add(Motor_core &motor,
+                            const Fault_reaction &reaction) {
+  if (motor.ID() >= slot_of.size() || slot_of[motor.ID()] != NO_SLOT) {
+    LOG_ERROR("Motor ID {:x} invalid or already monitored", motor.ID());
+    throw std::runtime_error("Motor already monitored");
+  }
+  uint32_t slot = Size();
+  auto entry = std::make_unique<Entry>();
+  entry->motor = &motor;
+  entry->reaction = reaction;
+  entry->last.store(motor.motor_info.error_code);
+  entry->latched.store(false);
+  entry->detected.store(0);
+  entry->staged_detected = 0;
+  entry->staged = false;
+  entries.push_back(std::move(entry));
+  slot_of[motor.ID()] = static_cast<uint16_t>(slot);
+  motor.AttachFaultMonitor(this, slot);
+  return slot;
+}
+
+void Fault_monitor::AddHandler(Fault_handler handler, uint32_t codes) {
+  handlers.push_back({codes, std::move(handler)});
+}
+
+bool Fault_monitor::Observe(uint32_t slot, ErrorCode code) {
+  Entry &entry = *entries[slot];
+  ErrorCode previous = static_cast<ErrorCode>(
+      entry.last.load(std::memory_order_relaxed));
+  if (code == previous) {
+    return false;
+  }
+  uint64_t now = Log::Now();
+  // 与 Clear 之间按顺序一致：Clear 解除锁存后必能看到新的错误码
+  entry.last.store(code);
+
+  if (code != NO_ERROR && entry.reaction.action != ACTION_NONE &&
+      !entry.latched.load()) {
+    entry.detected.store(now, std::memory_order_relaxed);
+    if (!entry.latched.exchange(true)) {
+      active.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  Fault_event event = {entry.motor->ID(), static_cast<uint16_t>(slot),
+                       previous, code, now};
+  if (!queue->Push(event)) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+uint32_t Fault_monitor::Observe(const Feedback_batch &batch) {
+  uint32_t events = 0;
+  for (uint32_t i = 0; i < batch.count; i++) {
+    uint16_t slot = Slot(batch.motor_id[i]);
+    if (slot != NO_SLOT &&
+        Observe(slot, static_cast<ErrorCode>(batch.error_code[i]))) {
+      events++;
+    }
+  }
+  return events;
+}
+
+uint32_t Fault_monitor::Stage(Frame_batch &batch) {
+  staged = 0;
+  if (active.load(std::memory_order_acquire) == 0) {
+    return 0;
+  }
+  for (auto &entry : entries) {
+    entry->staged = false;
+    if (!entry->latched.load(std::memory_order_acquire)) {
+      entry->staged_detected = 0;
+      continue;
+    }
+    // 上一次暂存后未经 Transmit 发出时保留原检测时刻
+    if (!entry->staged_detected) {
+      entry->staged_detected =
+          entry->detected.exchange(0, std::memory_order_acq_rel);
+    }
+
+    const Fault_reaction &reaction = entry->reaction;
+    scratch.Clear();
+    CAN_OBJ *msg =
+        reaction.action == ACTION_BRAKE
+            ? entry->motor->StageControlWithMode(scratch, reaction.brake_mode,
+                                                 reaction.value,
+                                                 reaction.ack_status)
+            : entry->motor->StageControlWithMode(scratch, CURRENT_MODE, 0.0f,
+                                                 reaction.ack_status);
+    if (!msg) {
+      LOG_EVERY(Log::ERROR, 100, "Invalid fault reaction of motor {:x}",
+                entry->motor->ID());
+      continue;
+    }
+    entry->frame = *msg;
+    entry->staged = true;
+    staged++;
+    // 原地替换，该电机的正常命令不会先于反应帧发出
+    if (!batch.Override(entry->motor, entry->frame)) {
+      LOG_EVERY(Log::ERROR, 100,
+                "No room for fault reaction of motor {:x}, sent alone",
+                entry->motor->ID());
+    }
+  }
+  return staged;
+}
+
+DWORD Fault_monitor::Transmit(Frame_batch &batch,
+                              EcanVci::Can_backend_handle can_transport) {
+  DWORD sent = batch.Transmit(can_transport);
+  if (staged == 0) {
+    return sent;
+  }
+  for (auto &entry : entries) {
+    if (!entry->staged) {
+      continue;
+    }
+    entry->staged = false;
+    // Override 之后批次中该电机只有反应帧一帧
+    bool in_batch = false;
+    for (DWORD i = 0; i < sent && !in_batch; i++) {
+      in_batch = batch.Owner(i) == entry->motor;
+    }
+    if (!in_batch) {
+      if (can_transport.Transmit(&entry->frame, 1) != 1) {
+        // 留待下一周期再次暂存，延迟照常累计
+        LOG_EVERY(Log::ERROR, 100, "Fault reaction of motor {:x} not sent",
+                  entry->motor->ID());
+        continue;
+      }
+      entry->motor->Track(entry->frame);
+    }
+
+    uint64_t detected = std::exchange(entry->staged_detected, 0);
+    if (!detected) {
+      continue;
+    }
+    uint64_t now = Log::Now();
+    uint64_t latency = now > detected ? now - detected : 0;
+    reactions.fetch_add(1, std::memory_order_relaxed);
+    total_latency.fetch_add(latency, std::memory_order_relaxed);
+    if (latency > max_latency.load(std::memory_order_relaxed)) {
+      max_latency.store(latency, std::memory_order_relaxed);
+    }
+    if (latency > static_cast<uint64_t>(period.count())) {
+      over_budget.fetch_add(1, std::memory_order_relaxed);
+      LOG_EVERY(Log::WARN, 100, "Fault reaction of motor {:x} took {} ns",
+                entry->motor->ID(), latency);
+    }
+  }
+  staged = 0;
+  return sent;
+}
+
+uint32_t Fault_monitor::Dispatch() {
+  Fault_event event;
+  uint32_t count = 0;
+  while (queue->Pop(event)) {
+    if (event.current != NO_ERROR) {
+      LOG_WARN("Motor {:x} error code {} -> {}", event.motor_id,
+               static_cast<int>(event.previous),
+               static_cast<int>(event.current));
+    } else {
+      LOG_INFO("Motor {:x} recovered from error code {}", event.motor_id,
+               static_cast<int>(event.previous));
+    }
+    for (const Handler &handler : handlers) {
+      if (handler.codes & FaultMask(event.current)) {
+        handler.handler(event);
+      }
+    }
+    count++;
+  }
+  return count;
+}
+
+DWORD Fault_monitor::Clear(uint32_t slot) {
+  Entry &entry = *entries.at(slot);
+  if (entry.last.load() != NO_ERROR) {
+    return STATUS_ERR;
+  }
+  if (entry.latched.exchange(false)) {
+    entry.detected.store(0, std::memory_order_relaxed);
+    active.fetch_sub(1, std::memory_order_release);
+  }
+  // 解除前接收线程可能刚报告新的故障而未锁存，此时重新锁存
+  if (entry.last.load() != NO_ERROR && entry.reaction.action != ACTION_NONE &&
+      !entry.latched.exchange(true)) {
+    entry.detected.store(Log::Now(), std::memory_order_relaxed);
+    active.fetch_add(1, std::memory_order_release);
+    return STATUS_ERR;
+  }
+  return STATUS_OK;
+}
+
+} // namespace Motor
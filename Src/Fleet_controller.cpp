@@ -0,0 +1,137 @@
+/**
+ * @file Fleet_controller.cpp
+ * @brief 实现 Fleet_controller.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Fleet_controller.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Motor {
+
+Fleet_controller::Fleet_controller() : axes(std::make_unique<Axes>()) {
+  axis_of.fill(NO_AXIS);
+  motors.reserve(FLEET_SIZE);
+  outputs.reserve(FLEET_SIZE);
+}
+
+uint32_t Fleet_controller::Add(const Motor_core &motor,
+                               const Axis_config &config) {
+  if (motors.size() >= FLEET_SIZE) {
+    throw std::runtime_error("Fleet is full");
+  }
+  if (motor.ID() >= axis_of.size() || axis_of[motor.ID()] != NO_AXIS) {
+    LOG_ERROR("Motor ID {:x} invalid or already in fleet", motor.ID());
+    throw std::runtime_error("Motor already in fleet");
+  }
+  uint32_t axis = Size();
+  motors.push_back(&motor);
+  outputs.push_back(config.output);
+  axis_of[motor.ID()] = static_cast<uint16_t>(axis);
+
+  SetGains(axis, config);
+  SetSetpoint(axis, 0.0f);
+  axes->position[axis] = 0.0f;
+  axes->speed[axis] = 0.0f;
+  axes->integral[axis] = 0.0f;
+  axes->output[axis] = 0.0f;
+  return axis;
+}
+
+void Fleet_controller::SetSetpoint(uint32_t axis, float position, float speed,
+                                   float feedforward) {
+  axes->position_setpoint[axis] = position;
+  axes->speed_setpoint[axis] = speed;
+  axes->feedforward[axis] = feedforward;
+}
+
+void Fleet_controller::SetGains(uint32_t axis, const Axis_config &config) {
+  const PID_parameters &pid = config.pid;
+  axes->kp[axis] = pid.kp;
+  axes->ki[axis] = pid.ki;
+  axes->kd[axis] = pid.kd;
+  // 跟踪时间常数默认取积分时间 kp / ki
+  axes->kaw[axis] = config.kaw.value_or(pid.kp > 0.0f ? pid.ki / pid.kp : 0.0f);
+  axes->output_min[axis] = -config.output_limit;
+  axes->output_max[axis] = config.output_limit;
+  outputs[axis] = config.output;
+}
+
+void Fleet_controller::Reset() {
+  std::fill_n(axes->integral, Size(), 0.0f);
+}
+
+uint32_t Fleet_controller::UpdateFeedback(const Feedback_batch &batch) {
+  uint32_t matched = 0;
+  for (uint32_t i = 0; i < batch.count; i++) {
+    uint16_t axis = Axis(batch.motor_id[i]);
+    if (axis == NO_AXIS) {
+      continue;
+    }
+    axes->position[axis] = batch.position[i];
+    axes->speed[axis] = batch.speed[i];
+    matched++;
+  }
+  return matched;
+}
+
+void Fleet_controller::UpdateFeedback() {
+  for (uint32_t axis = 0; axis < Size(); axis++) {
+    axes->position[axis] = motors[axis]->motor_info.position;
+    axes->speed[axis] = motors[axis]->motor_info.speed;
+  }
+}
+
+void Fleet_controller::UpdateFeedback(const Estimator_bank &estimator) {
+  const Estimator_bank::Axes &estimate = estimator.Data();
+  for (uint32_t axis = 0; axis < Size(); axis++) {
+    uint16_t index = estimator.Axis(motors[axis]->ID());
+    if (index == Estimator_bank::NO_AXIS) {
+      continue;
+    }
+    axes->position[axis] = estimate.predicted_position[index];
+    axes->speed[axis] = estimate.speed[index];
+  }
+}
+
+void Fleet_controller::Compute(float dt) {
+  Axes &a = *axes;
+  Simd::Pid({a.kp, a.ki, a.kd, a.kaw, a.output_min, a.output_max,
+             a.position_setpoint, a.speed_setpoint, a.feedforward, a.position,
+             a.speed, a.integral, a.output},
+            Size(), dt);
+}
+
+uint32_t Fleet_controller::Stage(Frame_batch &batch,
+                                 Message_return_status ack_status) const {
+  uint32_t staged = 0;
+  for (uint32_t axis = 0; axis < Size(); axis++) {
+    const Motor_core &motor = *motors[axis];
+    float output = axes->output[axis];
+    CAN_OBJ *msg = nullptr;
+    switch (outputs[axis]) {
+    case OUTPUT_CURRENT:
+      msg = motor.StageControlWithMode(batch, CURRENT_MODE, output, ack_status);
+      break;
+    case OUTPUT_TORQUE:
+      msg = motor.StageControlWithMode(batch, TORQUE_MODE, output, ack_status);
+      break;
+    default:
+      // kp、kd 为 0 时电机只执行力矩，位置与速度仅随帧带上设定值
+      msg = motor.StageHybrid(batch, 0.0f, 0.0f, axes->position_setpoint[axis],
+                              axes->speed_setpoint[axis], output);
+      break;
+    }
+    if (!msg) {
+      break;
+    }
+    staged++;
+  }
+  return staged;
+}
+
+} // namespace Motor
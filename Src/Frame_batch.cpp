@@ -0,0 +1,88 @@
+/**
+ * @file Frame_batch.cpp
+ * @brief 实现 Frame_batch.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Frame_batch.hpp"
+#include "Logger.hpp"
+#include "Motor_control.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace Motor {
+
+Frame_batch::Frame_batch(uint32_t capacity)
+    : frames(capacity), owners(capacity, nullptr), types(capacity, 0),
+      size(0), reserved(0) {}
+
+CAN_OBJ *Frame_batch::Acquire(const Motor_core *owner, uint8_t type,
+                              const CAN_OBJ &frame_template) {
+  if (size + reserved >= frames.size()) {
+    LOG_EVERY(Log::ERROR, 1000, "Frame batch full, capacity {}, reserved {}",
+              Capacity(), reserved);
+    return nullptr;
+  }
+  uint32_t index = size++;
+  if (owners[index] != owner || types[index] != type) {
+    frames[index] = frame_template;
+    owners[index] = owner;
+    types[index] = type;
+  }
+  return &frames[index];
+}
+
+void Frame_batch::Reserve(uint32_t count) {
+  reserved = std::min(count, Capacity());
+}
+
+CAN_OBJ *Frame_batch::Override(const Motor_core *owner, const CAN_OBJ &frame) {
+  uint32_t index = size, kept = 0;
+  for (uint32_t i = 0; i < size; i++) {
+    if (owners[i] == owner) {
+      if (index != size) {
+        continue;
+      }
+      index = kept;
+    }
+    // 删去的帧交换到末尾之后，各位置的内容与记录仍然对应
+    if (kept != i) {
+      std::swap(frames[kept], frames[i]);
+      std::swap(owners[kept], owners[i]);
+      std::swap(types[kept], types[i]);
+    }
+    kept++;
+  }
+  if (index == size) {
+    if (kept == frames.size()) {
+      LOG_EVERY(Log::ERROR, 1000, "Frame batch full, capacity {}", kept);
+      size = kept;
+      return nullptr;
+    }
+    index = kept++;
+  }
+  size = kept;
+  frames[index] = frame;
+  owners[index] = owner;
+  types[index] = TYPE_OVERRIDE;
+  return &frames[index];
+}
+
+DWORD Frame_batch::Transmit(EcanVci::Can_backend_handle can_transport) {
+  if (size == 0) {
+    return 0;
+  }
+  DWORD result = can_transport.Transmit(frames.data(), size);
+  if (result != size) {
+    LOG_EVERY(Log::ERROR, 1000, "Batch transmit sent {} of {} frames", result,
+              size);
+  }
+  for (DWORD i = 0; i < result; i++) {
+    owners[i]->Track(frames[i]);
+  }
+  return result;
+}
+
+} // namespace Motor
@@ -0,0 +1,91 @@
+/**
+ * @file Half_float.cpp
+ * @brief 实现 Half_float.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Half_float.hpp"
+#include "Simd.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HALF_X86 1
+#else
+#define HALF_X86 0
+#endif
+
+namespace Half {
+
+namespace {
+
+bool DetectF16c() {
+#if HALF_X86
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+#else
+  return false;
+#endif
+}
+
+const bool f16c_supported = DetectF16c();
+
+#if HALF_X86
+
+__attribute__((target("avx,f16c"))) void
+FromFloatF16c(const float values[], uint16_t halves[], uint32_t len) {
+  uint32_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(values + i),
+                                _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(halves + i), h);
+  }
+  for (; i < len; i++) {
+    halves[i] = FromFloat(values[i]);
+  }
+}
+
+__attribute__((target("avx,f16c"))) void
+ToFloatF16c(const uint16_t halves[], float values[], uint32_t len) {
+  uint32_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(halves + i));
+    _mm256_storeu_ps(values + i, _mm256_cvtph_ps(h));
+  }
+  for (; i < len; i++) {
+    values[i] = ToFloat(halves[i]);
+  }
+}
+
+#endif
+
+} // namespace
+
+bool UsingF16c() {
+  return f16c_supported && Simd::GetLevel() >= Simd::LEVEL_AVX2;
+}
+
+void FromFloat(const float values[], uint16_t halves[], uint32_t len) {
+#if HALF_X86
+  if (UsingF16c()) {
+    return FromFloatF16c(values, halves, len);
+  }
+#endif
+  for (uint32_t i = 0; i < len; i++) {
+    halves[i] = FromFloat(values[i]);
+  }
+}
+
+void ToFloat(const uint16_t halves[], float values[], uint32_t len) {
+#if HALF_X86
+  if (UsingF16c()) {
+    return ToFloatF16c(halves, values, len);
+  }
+#endif
+  for (uint32_t i = 0; i < len; i++) {
+    values[i] = ToFloat(halves[i]);
+  }
+}
+
+} // namespace Half
@@ -0,0 +1,276 @@
+/**
+ * @file Logger.cpp
+ * @brief 实现 Logger.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Logger.hpp"
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Log {
+
+namespace {
+
+constexpr uint32_t BUFFER_SIZE = 1024; // 每线程记录条数，2 的幂
+
+/**
+ * @brief 每线程单生产者单消费者环形缓冲区
+ */
+struct Buffer {
+  alignas(64) std::atomic<uint32_t> head{0}; // 生产者写
+  alignas(64) std::atomic<uint32_t> tail{0}; // 消费者写
+  alignas(64) std::atomic<bool> retired{false};
+  uint32_t thread_id;
+  Record records[BUFFER_SIZE];
+};
+
+class Backend {
+  std::mutex buffers_mutex;
+  std::vector<std::unique_ptr<Buffer>> buffers;
+  uint32_t next_thread_id = 0;
+
+  std::atomic<bool> running{true};
+  std::atomic<bool> stopped{false};
+  std::atomic<uint64_t> rounds{0};
+  // Drain 在后台线程中调用，停止后也可能在写日志的线程中调用
+  std::mutex drain_mutex;
+  std::string line;
+
+  void Format(const Buffer &buffer, const Record &record);
+  void Run();
+
+public:
+  std::atomic<Level> level{INFO};
+  std::atomic<uint64_t> dropped{0};
+
+  Backend() { thread = std::thread(&Backend::Run, this); }
+
+  Buffer *Register();
+
+  bool Drain();
+  void Flush();
+
+  /**
+   * @brief 停止后台线程并输出剩余记录，进程退出时调用一次
+   */
+  void Stop();
+
+  bool Stopped() const { return stopped.load(std::memory_order_acquire); }
+
+private:
+  std::thread thread; // 最后构造，启动时其他成员均已就绪
+};
+
+Backend &Instance() {
+  // 不析构：线程退出与静态析构时仍可能写日志，缓冲区必须一直有效
+  static Backend *backend = [] {
+    Backend *instance = new Backend;
+    std::atexit([] { Instance().Stop(); });
+    return instance;
+  }();
+  return *backend;
+}
+
+// 本线程的缓冲区，普通指针在线程的整个生命周期内都可访问
+thread_local Buffer *thread_buffer = nullptr;
+
+/**
+ * @brief 线程退出时把缓冲区交给后台线程回收
+ * 之后本线程（如主线程的静态析构）再写日志时重新登记一个缓冲区，
+ * 该缓冲区不再回收
+ */
+struct Thread_retire {
+  ~Thread_retire() {
+    if (thread_buffer) {
+      thread_buffer->retired.store(true, std::memory_order_release);
+      thread_buffer = nullptr;
+    }
+  }
+};
+
+thread_local Thread_retire thread_retire;
+
+Buffer *Backend::Register() {
+  auto buffer = std::make_unique<Buffer>();
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  buffer->thread_id = next_thread_id++;
+  buffers.push_back(std::move(buffer));
+  return buffers.back().get();
+}
+
+void Backend::Format(const Buffer &buffer, const Record &record) {
+  static const char level_char[] = {'D', 'I', 'W', 'E'};
+  char head[64];
+  snprintf(head, sizeof(head), "[%6" PRIu64 ".%06" PRIu64 "] %c/%u ",
+           static_cast<uint64_t>(record.timestamp / 1000000000ULL),
+           static_cast<uint64_t>(record.timestamp % 1000000000ULL / 1000ULL),
+           level_char[record.site->level & 0x03], buffer.thread_id);
+  line += head;
+
+  char value[32];
+  int index = 0;
+  for (const char *p = record.site->format; *p; p++) {
+    bool hex = strncmp(p, "{:x}", 4) == 0;
+    if (!(p[0] == '{' && p[1] == '}') && !hex) {
+      line += *p;
+      continue;
+    }
+    p += hex ? 3 : 1;
+    if (index >= record.arg_count) {
+      line += "{}";
+      continue;
+    }
+    auto &arg = record.args[index];
+    switch (static_cast<Arg_type>(record.arg_types[index++])) {
+    case ARG_INT:
+      snprintf(value, sizeof(value), hex ? "%" PRIx64 : "%" PRId64, arg.i);
+      break;
+    case ARG_UINT:
+      snprintf(value, sizeof(value), hex ? "%" PRIx64 : "%" PRIu64, arg.u);
+      break;
+    case ARG_DOUBLE:
+      snprintf(value, sizeof(value), "%g", arg.d);
+      break;
+    case ARG_STRING:
+      if (arg.u < MAX_TEXT) {
+        line += record.text + arg.u;
+      }
+      continue;
+    case ARG_POINTER:
+      snprintf(value, sizeof(value), "%p", arg.p);
+      break;
+    }
+    line += value;
+  }
+
+  if (record.suppressed) {
+    snprintf(value, sizeof(value), " (suppressed %u)", record.suppressed);
+    line += value;
+  }
+  line += '\n';
+}
+
+bool Backend::Drain() {
+  std::lock_guard<std::mutex> drain_lock(drain_mutex);
+  std::vector<Buffer *> snapshot;
+  {
+    std::lock_guard<std::mutex> lock(buffers_mutex);
+    snapshot.reserve(buffers.size());
+    for (auto &buffer : buffers) {
+      snapshot.push_back(buffer.get());
+    }
+  }
+
+  uint64_t count = 0;
+  line.clear();
+  for (Buffer *buffer : snapshot) {
+    uint32_t tail = buffer->tail.load(std::memory_order_relaxed);
+    uint32_t head = buffer->head.load(std::memory_order_acquire);
+    for (; tail != head; tail++, count++) {
+      Format(*buffer, buffer->records[tail & (BUFFER_SIZE - 1)]);
+    }
+    buffer->tail.store(tail, std::memory_order_release);
+  }
+  if (!line.empty()) {
+    fwrite(line.data(), 1, line.size(), stdout);
+    fflush(stdout);
+  }
+
+  // 回收已退出线程的空缓冲区
+  std::lock_guard<std::mutex> lock(buffers_mutex);
+  for (auto it = buffers.begin(); it != buffers.end();) {
+    Buffer &buffer = **it;
+    if (buffer.retired.load(std::memory_order_acquire) &&
+        buffer.head.load(std::memory_order_acquire) ==
+            buffer.tail.load(std::memory_order_relaxed)) {
+      it = buffers.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return count > 0;
+}
+
+void Backend::Run() {
+  while (running.load(std::memory_order_acquire)) {
+    bool busy = Drain();
+    rounds.fetch_add(1, std::memory_order_release);
+    if (!busy) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  Drain();
+}
+
+void Backend::Flush() {
+  // 调用之后完整开始的一轮 Drain 结束时，之前提交的记录都已输出
+  uint64_t target = rounds.load(std::memory_order_acquire) + 2;
+  while (rounds.load(std::memory_order_acquire) < target &&
+         running.load(std::memory_order_acquire)) {
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+}
+
+void Backend::Stop() {
+  running.store(false, std::memory_order_release);
+  thread.join();
+  // 后台线程最后一轮 Drain 之后、置位之前提交的记录由这里输出
+  stopped.store(true, std::memory_order_release);
+  Drain();
+  uint64_t lost = dropped.load(std::memory_order_relaxed);
+  if (lost) {
+    fprintf(stderr, "Log dropped %" PRIu64 " records\n", lost);
+  }
+}
+
+} // namespace
+
+Record *Acquire() {
+  Buffer *buffer = thread_buffer;
+  if (!buffer) {
+    buffer = thread_buffer = Instance().Register();
+    // 首次使用时构造，线程退出时析构
+    static_cast<void>(&thread_retire);
+  }
+  uint32_t head = buffer->head.load(std::memory_order_relaxed);
+  if (head - buffer->tail.load(std::memory_order_acquire) >= BUFFER_SIZE) {
+    Instance().dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return &buffer->records[head & (BUFFER_SIZE - 1)];
+}
+
+void Commit() {
+  Buffer *buffer = thread_buffer;
+  buffer->head.store(buffer->head.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+  // 后台线程已停止，在本线程输出
+  if (Instance().Stopped()) {
+    Instance().Drain();
+  }
+}
+
+void SetLevel(Level level) {
+  Instance().level.store(level, std::memory_order_relaxed);
+}
+
+Level GetLevel() { return Instance().level.load(std::memory_order_relaxed); }
+
+void Flush() { Instance().Flush(); }
+
+uint64_t DroppedCount() {
+  return Instance().dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace Log
@@ -0,0 +1,227 @@
+/**
+ * @file Motor_async.cpp
+ * @brief 实现 Motor_async.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Motor_async.hpp"
+#include "Logger.hpp"
+#include "Motor_control.hpp"
+#include <algorithm>
+
+namespace Motor {
+
+Async_executor::Async_executor(EcanVci::Can_backend_handle can_transport)
+    : can_transport(can_transport), waiter_count(0), live_tasks(0),
+      reply_timeout(std::chrono::milliseconds(5)) {}
+
+DWORD Async_executor::Attach(Motor_core &motor) {
+  if (dispatch_table.Register(motor) != STATUS_OK) {
+    return STATUS_ERR;
+  }
+  motor.executor = this;
+  UpdateFilter();
+  return STATUS_OK;
+}
+
+void Async_executor::Detach(Motor_core &motor) {
+  dispatch_table.Unregister(motor);
+  if (motor.executor == this) {
+    motor.executor = nullptr;
+  }
+  UpdateFilter();
+}
+
+void Async_executor::UpdateFilter() {
+  // 过滤失败时后端仍按旧过滤接收，由后端记录错误
+  can_transport.SetFilter(dispatch_table.FilterIds());
+}
+
+void Async_executor::SetReplyTimeout(std::chrono::microseconds timeout) {
+  reply_timeout = timeout;
+}
+
+Async_executor::Detached Async_executor::Drive(Task<void> task) {
+  try {
+    co_await task;
+  } catch (...) {
+    LOG_ERROR("Async task failed");
+    if (!failure) {
+      failure = std::current_exception();
+    }
+  }
+  live_tasks--;
+}
+
+void Async_executor::Spawn(Task<void> task) {
+  live_tasks++;
+  ready.push_back(Drive(std::move(task)).handle);
+}
+
+bool Async_executor::Submit(Reply_waiter &waiter,
+                            std::coroutine_handle<> handle) {
+  if (can_transport.Transmit(&waiter.request, 1) != 1) {
+    waiter.status = STATUS_ERR;
+    return false;
+  }
+  if (waiter.owner) {
+    waiter.owner->Track(waiter.request);
+  }
+  if (waiter.match.kind == REPLY_NONE) {
+    waiter.status = STATUS_OK;
+    return false;
+  }
+  waiter.handle = handle;
+  waiter.deadline = std::chrono::steady_clock::now() + reply_timeout;
+  uint64_t key = waiter.match.Key();
+  waiters[key].push_back(&waiter);
+  waiter_count++;
+  deadlines.push({waiter.deadline, key, &waiter});
+  return true;
+}
+
+bool Async_executor::Armed(const Deadline &entry) const {
+  auto group = waiters.find(entry.key);
+  if (group == waiters.end()) {
+    return false;
+  }
+  const std::deque<Reply_waiter *> &queue = group->second;
+  // 先确认请求仍在队列中，已应答的请求可能已随协程帧释放
+  return std::find(queue.begin(), queue.end(), entry.waiter) != queue.end() &&
+         entry.waiter->deadline == entry.deadline;
+}
+
+void Async_executor::Dispatch(const CAN_OBJ &msg) {
+  // 0x7FF 管理帧只交给应答关联
+  if (!Dispatch_table::IsManagement(msg)) {
+    const Dispatch_table::Entry *entry = dispatch_table.Find(msg);
+    if (entry) {
+      entry->motor->ProcessFrame(msg);
+    }
+  }
+
+  if (waiter_count == 0) {
+    return;
+  }
+  auto group = waiters.find(Reply_match::Key(msg));
+  if (group == waiters.end()) {
+    return;
+  }
+  // 同一匹配条件的请求按发出顺序应答，同一键下只有应答类型不同的请求
+  std::deque<Reply_waiter *> &queue = group->second;
+  for (auto it = queue.begin(); it != queue.end(); ++it) {
+    Reply_waiter &waiter = **it;
+    if (waiter.match.Matches(msg)) {
+      waiter.reply = msg;
+      waiter.status = STATUS_OK;
+      ready.push_back(waiter.handle);
+      queue.erase(it);
+      waiter_count--;
+      if (queue.empty()) {
+        waiters.erase(group);
+      }
+      return;
+    }
+  }
+}
+
+void Async_executor::Expire(std::chrono::steady_clock::time_point now) {
+  while (!timers.empty() && timers.begin()->first <= now) {
+    ready.push_back(timers.begin()->second);
+    timers.erase(timers.begin());
+  }
+
+  while (!deadlines.empty() && deadlines.top().deadline <= now) {
+    Deadline entry = deadlines.top();
+    deadlines.pop();
+    if (!Armed(entry)) {
+      continue;
+    }
+    Reply_waiter &waiter = *entry.waiter;
+    if (waiter.retries_left > 0 &&
+        can_transport.Transmit(&waiter.request, 1) == 1) {
+      // 重发同样记入命令历史
+      if (waiter.owner) {
+        waiter.owner->Track(waiter.request);
+      }
+      waiter.retries_left--;
+      waiter.deadline = now + reply_timeout;
+      deadlines.push({waiter.deadline, entry.key, &waiter});
+      continue;
+    }
+    LOG_EVERY(Log::WARN, 1000, "Reply timeout, id: {:x}",
+              waiter.request.ID == 0x7FF ? waiter.match.management_id
+                                         : waiter.request.ID);
+    waiter.status = STATUS_ERR;
+    ready.push_back(waiter.handle);
+    auto group = waiters.find(entry.key);
+    std::deque<Reply_waiter *> &queue = group->second;
+    queue.erase(std::find(queue.begin(), queue.end(), &waiter));
+    waiter_count--;
+    if (queue.empty()) {
+      waiters.erase(group);
+    }
+  }
+}
+
+void Async_executor::ResumeReady() {
+  while (!ready.empty()) {
+    auto handle = ready.front();
+    ready.pop_front();
+    handle.resume();
+  }
+}
+
+void Async_executor::Poll(INT wait_time) {
+  ResumeReady();
+
+  auto now = std::chrono::steady_clock::now();
+  INT wait = 0;
+  if (waiter_count > 0 || !timers.empty()) {
+    auto next = NextDeadline();
+    if (next > now) {
+      auto remain = std::chrono::ceil<std::chrono::milliseconds>(next - now);
+      wait = static_cast<INT>(
+          std::min<std::chrono::milliseconds::rep>(remain.count(), wait_time));
+    }
+  }
+
+  DWORD count = can_transport.Receive(receive_buffer, 100, wait);
+  for (DWORD i = 0; i < count; i++) {
+    Dispatch(receive_buffer[i]);
+  }
+
+  Expire(std::chrono::steady_clock::now());
+  ResumeReady();
+}
+
+std::chrono::steady_clock::time_point Async_executor::NextDeadline() const {
+  auto next = std::chrono::steady_clock::time_point::max();
+  if (!timers.empty()) {
+    next = timers.begin()->first;
+  }
+  // 丢弃堆顶已应答或已重发的项，使返回值不早于真实的最早超时
+  if (waiter_count == 0) {
+    deadlines = {};
+  }
+  while (!deadlines.empty() && !Armed(deadlines.top())) {
+    deadlines.pop();
+  }
+  if (!deadlines.empty()) {
+    next = std::min(next, deadlines.top().deadline);
+  }
+  return next;
+}
+
+void Async_executor::Run() {
+  while (live_tasks > 0) {
+    Poll();
+  }
+  if (failure) {
+    std::rethrow_exception(std::exchange(failure, nullptr));
+  }
+}
+
+} // namespace Motor
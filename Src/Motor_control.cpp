@@ -7,26 +7,49 @@
  */
 
 #include "Motor_control.hpp"
+#include "Fault_monitor.hpp"
+#include "Frame_batch.hpp"
+#include "Logger.hpp"
+#include "Motor_backends.hpp"
+#include "Profiler.hpp"
+#include "Telemetry.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstring>
-#include <iostream>
+#include <stdexcept>
 
 namespace Motor {
 
-DWORD Motor_control::UpdateInfo() {
+template <EcanVci::Can_backend Backend>
+DWORD Basic_motor_control<Backend>::UpdateInfo() {
   // 更新信息的具体实现
-  uint8_t data[8];
-  UINT source, len;
-  auto result = can_transport.ReceiveLast(source, data, len);
+  CAN_OBJ msgs[100];
+  auto result = can_transport.Receive(msgs, 100);
 
   if (result == 0) {
-    std::cerr << "Receive failed\n";
+    LOG_EVERY(Log::ERROR, 1000, "Receive failed");
     return STATUS_ERR;
   }
 
-  if (source != ((id_high << 8) | id_low)) {
-    std::cerr << "Source ID error\n";
+  DWORD status = STATUS_ERR;
+  for (DWORD i = 0; i < result; i++) {
+    if (ProcessFrame(msgs[i]) == STATUS_OK) {
+      status = STATUS_OK;
+    }
+  }
+  if (status != STATUS_OK) {
+    LOG_EVERY(Log::ERROR, 1000, "Source ID error: {:x}", msgs[result - 1].ID);
+  }
+  return status;
+}
+
+DWORD Motor_core::ProcessFrame(const CAN_OBJ &msg) {
+  MOTOR_PROFILE_SCOPE(PHASE_DECODE);
+  if (msg.ID != ID() || msg.DataLen == 0) {
     return STATUS_ERR;
   }
+  const BYTE *data = msg.Data;
 
   /*// DEBUG
   std::cout << "Receive data: ";
@@ -38,184 +61,710 @@ DWORD Motor_control::UpdateInfo() {
 
   switch (static_cast<Message_return_status>((data[0] >> 5) & 0b111)) {
   case Message_return_status::ACK_TYPE_1:
-    // 处理ACK_TYPE_1
-    motor_info.error_code = static_cast<ErrorCode>(data[0] & 0b11111);
-    motor_info.position = static_cast<float>(data[1] << 8 | data[2]);
-    motor_info.speed = static_cast<float>(data[3] << 4 | data[4] >> 4) - 2047;
-    motor_info.current =
-        static_cast<float>((data[4] & 0x0F) << 8 | data[5]) - 2047;
-    motor_info.motor_temperature = (data[6] - 50) >> 1;
-    motor_info.MOS_temperature = (data[7] - 50) >> 1;
-    break;
   case Message_return_status::ACK_TYPE_2:
-    // 处理ACK_TYPE_2
-    break;
   case Message_return_status::ACK_TYPE_3:
-    // 处理ACK_TYPE_3
+    // 量程与比例由电机型号决定
+    if (model.DecodeAck(msg, motor_info) != STATUS_OK) {
+      return STATUS_ERR;
+    }
+    if (fault_monitor) {
+      fault_monitor->Observe(fault_slot, motor_info.error_code);
+    }
     break;
   case Message_return_status::ACK_TYPE_4:
     // 处理ACK_TYPE_4
     break;
-  case Message_return_status::ACK_TYPE_5:
-    // 处理ACK_TYPE_5
+  case Message_return_status::ACK_TYPE_5: {
+    Parameter_code code;
+    std::optional<float> value = DecodeParameter(msg, code);
+    if (!value) {
+      return STATUS_ERR;
+    }
+    float *floats[] = {&motor_parameters.position, &motor_parameters.speed,
+                       &motor_parameters.current, &motor_parameters.power};
+    uint16_t *integers[] = {
+        &motor_parameters.acceleration, &motor_parameters.linkage_kp,
+        &motor_parameters.speed_ki, &motor_parameters.feedback_kp,
+        &motor_parameters.feedback_kd};
+    if (code <= PARAM_POWER) {
+      *floats[code - PARAM_POSITION] = *value;
+    } else {
+      *integers[code - PARAM_ACCELERATION] = static_cast<uint16_t>(*value);
+    }
     break;
+  }
   default:
     // 处理未知状态
     return STATUS_ERR;
   }
+  motor_info.motor_id = ID();
 
+  if (telemetry) {
+    telemetry->Publish(telemetry_slot, ID(), motor_info);
+  }
   return STATUS_OK;
 }
 
-Motor_control::Motor_control(const EcanVci::Can_transport &can_transport,
-                             uint8_t id_high, uint8_t id_low)
-    : motor_info({0}), can_transport(can_transport), id_high(id_high),
-      id_low(id_low), max_retry_times(3) {}
+Motor_core::Motor_core(uint8_t id_high, uint8_t id_low, Model_handle model)
+    : id_high(id_high), id_low(id_low), max_retry_times(3), model(model),
+      executor(nullptr), telemetry(nullptr), telemetry_slot(0),
+      fault_monitor(nullptr), fault_slot(0), motor_info({0}),
+      motor_parameters({}) {
+  InitFrames();
+}
+
+Motor_core::Motor_core(uint16_t id, Model_handle model)
+    : Motor_core(static_cast<uint8_t>(id >> 8), static_cast<uint8_t>(id & 0xFF),
+                 model) {}
 
-Motor_control::Motor_control(const EcanVci::Can_transport &can_transport,
-                             uint16_t id)
-    : motor_info({0}), can_transport(can_transport), id_high(id >> 8),
-      id_low(id & 0xFF), max_retry_times(3) {}
+template <EcanVci::Can_backend Backend>
+Basic_motor_control<Backend>::Basic_motor_control(const Backend &can_transport,
+                                                  uint8_t id_high,
+                                                  uint8_t id_low,
+                                                  Model_handle model)
+    : Motor_core(id_high, id_low, model), can_transport(can_transport) {}
 
-Motor_control::~Motor_control() {}
+template <EcanVci::Can_backend Backend>
+Basic_motor_control<Backend>::Basic_motor_control(const Backend &can_transport,
+                                                  uint16_t id,
+                                                  Model_handle model)
+    : Motor_core(id, model), can_transport(can_transport) {}
 
-void Motor_control::SetMaxRetryTimes(uint16_t max_retry_times) {
+Motor_core::~Motor_core() {}
+
+void Motor_core::ChangeID(uint16_t id) {
+  Async_executor *attached = executor;
+  if (attached) {
+    attached->Detach(*this);
+  }
+  id_high = static_cast<uint8_t>(id >> 8);
+  id_low = static_cast<uint8_t>(id & 0xFF);
+  InitFrames();
+  if (attached && attached->Attach(*this) != STATUS_OK) {
+    LOG_ERROR("Motor ID {:x} conflicts after ID change", id);
+  }
+}
+
+void Motor_core::SetMaxRetryTimes(uint16_t max_retry_times) {
   this->max_retry_times = max_retry_times;
-  // TODO 下面设置的都要用到这个，都还没写
 }
 
-Motor_control::status_type Motor_control::SendCmd() {
-  // 发送命令的具体实现
-  return 0;
+void Motor_core::AttachTelemetry(const Telemetry_publisher *telemetry,
+                                 uint32_t slot) {
+  this->telemetry = telemetry;
+  this->telemetry_slot = slot;
+}
+
+void Motor_core::AttachFaultMonitor(Fault_monitor *fault_monitor,
+                                    uint32_t slot) {
+  this->fault_monitor = fault_monitor;
+  this->fault_slot = slot;
+}
+
+void Motor_core::Track(const CAN_OBJ &msg) const {
+  if (telemetry) {
+    telemetry->RecordCommand(telemetry_slot, msg);
+  }
+}
+
+template <EcanVci::Can_backend Backend>
+Motor_core::status_type
+Basic_motor_control<Backend>::SendCmd(CAN_OBJ &msg) const {
+  // 直接发送帧本身，不再拷贝到临时 CAN_OBJ
+  if (can_transport.Transmit(&msg, 1) != 1) {
+    LOG_ERROR("Transmit failed");
+    throw std::runtime_error("Transmit failed");
+  }
+  Track(msg);
+  return STATUS_OK;
+}
+
+void Motor_core::EncodeSetting(CAN_OBJ &msg, uint8_t cmd) const {
+  msg = {};
+  msg.ID = 0x7FF;
+  msg.DataLen = 4;
+  msg.Data[0] = id_high;
+  msg.Data[1] = id_low;
+  msg.Data[2] = 0x00;
+  msg.Data[3] = cmd;
+}
+
+void Motor_core::EncodeResetID(CAN_OBJ &msg, uint16_t new_id) const {
+  EncodeSetting(msg, 0x04);
+  msg.DataLen = 6;
+  msg.Data[4] = static_cast<uint8_t>(new_id >> 8);
+  msg.Data[5] = static_cast<uint8_t>(new_id & 0xFF);
+}
+
+void Motor_core::EncodeResetIDBroadcast(CAN_OBJ &msg) {
+  msg = {};
+  msg.ID = 0x7FF;
+  msg.DataLen = 6;
+  const uint8_t data[6] = {0x7F, 0x7F, 0x00, 0x05, 0x7F, 0x7F};
+  memcpy(msg.Data, data, sizeof(data));
+}
+
+void Motor_core::EncodeQueryID(CAN_OBJ &msg) {
+  msg = {};
+  msg.ID = 0x7FF;
+  msg.DataLen = 4;
+  const uint8_t data[4] = {0xFF, 0xFF, 0x00, 0x82};
+  memcpy(msg.Data, data, sizeof(data));
+}
+
+void Motor_core::InitFrames() {
+  static constexpr uint8_t lengths[FRAME_TYPE_COUNT] = {
+      POSITION_FRAME_LENGTH, SPEED_FRAME_LENGTH, CURRENT_FRAME_LENGTH,
+      HYBRID_FRAME_LENGTH};
+  // 混合控制帧没有帧头，8 字节全部由 EncodeHybrid 写入
+  static constexpr uint8_t headers[FRAME_TYPE_COUNT] = {0x20, 0x40, 0x60, 0x00};
+  for (int i = 0; i < FRAME_TYPE_COUNT; i++) {
+    templates[i] = {};
+    templates[i].ID = ID();
+    templates[i].DataLen = lengths[i];
+    templates[i].Data[0] = headers[i];
+    frames[i] = templates[i];
+  }
 }
 
-Motor_control::status_type Motor_control::SetZero() const {
+void Motor_core::PatchPosition(CAN_OBJ &msg, float position, uint16_t speed,
+                               uint16_t current,
+                               Message_return_status ack_status) {
+  MOTOR_PROFILE_SCOPE(PHASE_ENCODE);
+  // 位置为 IEEE754 单精度，整体右移 3 位与速度、电流、应答类型拼成 8 字节
+  uint32_t position_bytes = std::bit_cast<uint32_t>(position);
+  uint8_t b3 = position_bytes >> 24, b2 = position_bytes >> 16,
+          b1 = position_bytes >> 8, b0 = position_bytes;
+
+  msg.Data[0] = 0x20 | (b3 >> 3);
+  msg.Data[1] = static_cast<uint8_t>(b3 << 5 | b2 >> 3);
+  msg.Data[2] = static_cast<uint8_t>(b2 << 5 | b1 >> 3);
+  msg.Data[3] = static_cast<uint8_t>(b1 << 5 | b0 >> 3);
+  msg.Data[4] = static_cast<uint8_t>(b0 << 5 | speed >> 10);
+  msg.Data[5] = static_cast<uint8_t>((speed & 0x3FC) >> 2);
+  msg.Data[6] = static_cast<uint8_t>((speed & 0x03) << 6 | current >> 6);
+  msg.Data[7] =
+      static_cast<uint8_t>((current & 0x3F) << 2 | (ack_status & 0x03));
+}
+
+void Motor_core::PatchSpeed(CAN_OBJ &msg, float speed, uint16_t current,
+                            Message_return_status ack_status) {
+  MOTOR_PROFILE_SCOPE(PHASE_ENCODE);
+  uint32_t speed_bytes = std::bit_cast<uint32_t>(speed);
+
+  msg.Data[0] = 0x40 | static_cast<uint8_t>(ack_status);
+  msg.Data[1] = 0xff & static_cast<uint8_t>(speed_bytes >> 24);
+  msg.Data[2] = 0xff & static_cast<uint8_t>(speed_bytes >> 16);
+  msg.Data[3] = 0xff & static_cast<uint8_t>(speed_bytes >> 8);
+  msg.Data[4] = 0xff & static_cast<uint8_t>(speed_bytes);
+  msg.Data[5] = 0xff & static_cast<uint8_t>(current >> 8);
+  msg.Data[6] = 0xff & static_cast<uint8_t>(current);
+}
+
+void Motor_core::PatchCurrent(CAN_OBJ &msg, uint16_t current,
+                              Message_return_status ack_status) {
+  MOTOR_PROFILE_SCOPE(PHASE_ENCODE);
+  msg.Data[0] = 0x60 | static_cast<uint8_t>(ack_status);
+  msg.Data[1] = 0xff & static_cast<uint8_t>(current >> 8);
+  msg.Data[2] = 0xff & static_cast<uint8_t>(current);
+}
+
+void Motor_core::PatchControlWithMode(CAN_OBJ &msg, Control_mode control_mode,
+                                      float current_or_torque,
+                                      Message_return_status ack_status) {
+  MOTOR_PROFILE_SCOPE(PHASE_ENCODE);
+  // 电流模式限幅 ±2000，力矩与制动模式限幅 ±3000
+  float limit = control_mode == CURRENT_MODE ? 2000.0f : 3000.0f;
+  int16_t value = static_cast<int16_t>(
+      std::lround(std::clamp(current_or_torque, -limit, limit)));
+
+  msg.Data[0] = 0x60 | static_cast<uint8_t>((control_mode & 0x07) << 2) |
+                static_cast<uint8_t>(ack_status & 0x03);
+  msg.Data[1] = static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8);
+  msg.Data[2] = static_cast<uint8_t>(value & 0xFF);
+}
+
+void Motor_core::EncodePosition(CAN_OBJ &msg, float position, uint16_t speed,
+                                uint16_t current,
+                                Message_return_status ack_status) const {
+  msg = templates[FRAME_POSITION];
+  PatchPosition(msg, position, speed, current, ack_status);
+}
+
+void Motor_core::EncodeSpeed(CAN_OBJ &msg, float speed, uint16_t current,
+                             Message_return_status ack_status) const {
+  msg = templates[FRAME_SPEED];
+  PatchSpeed(msg, speed, current, ack_status);
+}
+
+void Motor_core::EncodeCurrent(CAN_OBJ &msg, uint16_t current,
+                               Message_return_status ack_status) const {
+  msg = templates[FRAME_CURRENT];
+  PatchCurrent(msg, current, ack_status);
+}
+
+void Motor_core::EncodeControlWithMode(
+    CAN_OBJ &msg, Control_mode control_mode, float current_or_torque,
+    Message_return_status ack_status) const {
+  msg = templates[FRAME_CURRENT];
+  PatchControlWithMode(msg, control_mode, current_or_torque, ack_status);
+}
+
+void Motor_core::EncodeParameter(CAN_OBJ &msg, uint8_t code, uint16_t first,
+                                 uint16_t second,
+                                 Message_return_status ack_status) const {
+  // 子指令 1 为加速度，只带一个值；2、3 带两个值
+  msg = {};
+  msg.ID = ID();
+  msg.DataLen = code == 0x01 ? 4 : 6;
+  msg.Data[0] = 0xC0 | static_cast<uint8_t>(ack_status);
+  msg.Data[1] = code;
+  msg.Data[2] = static_cast<uint8_t>(first >> 8);
+  msg.Data[3] = static_cast<uint8_t>(first & 0xFF);
+  msg.Data[4] = static_cast<uint8_t>(second >> 8);
+  msg.Data[5] = static_cast<uint8_t>(second & 0xFF);
+}
+
+void Motor_core::EncodeGetParameter(CAN_OBJ &msg, Parameter_code code) const {
+  msg = {};
+  msg.ID = ID();
+  msg.DataLen = 2;
+  msg.Data[0] = 0xE0;
+  msg.Data[1] = code;
+}
+
+std::optional<float> Motor_core::DecodeParameter(const CAN_OBJ &msg,
+                                                 Parameter_code &code) {
+  const BYTE *data = msg.Data;
+  if (msg.DataLen < 2 || (data[0] >> 5) != ACK_TYPE_5 ||
+      data[1] < PARAM_POSITION || data[1] > PARAM_FEEDBACK_KD) {
+    return std::nullopt;
+  }
+  code = static_cast<Parameter_code>(data[1]);
+  if (code <= PARAM_POWER) {
+    // 大端单精度浮点
+    if (msg.DataLen != 6) {
+      return std::nullopt;
+    }
+    return std::bit_cast<float>(static_cast<uint32_t>(
+        data[2] << 24 | data[3] << 16 | data[4] << 8 | data[5]));
+  }
+  if (msg.DataLen != 4) {
+    return std::nullopt;
+  }
+  return static_cast<float>(data[2] << 8 | data[3]);
+}
+
+Reply_awaiter<DWORD> Motor_core::AwaitReply(const CAN_OBJ &msg,
+                                            Reply_match match) const {
+  return Reply_awaiter<DWORD>(
+      executor, this, msg, match, max_retry_times,
+      [](DWORD status, const CAN_OBJ &) { return status; });
+}
+
+Reply_awaiter<DWORD>
+Motor_core::AwaitAck(const CAN_OBJ &msg,
+                     Message_return_status ack_status) const {
+  return AwaitReply(msg, {ack_status == NO_ACK ? REPLY_NONE : REPLY_ACK,
+                          static_cast<uint8_t>(ack_status), 0, msg.ID});
+}
+
+Reply_awaiter<DWORD> Motor_core::RejectReply() {
+  // 没有执行器的 awaiter 不发送，直接以 STATUS_ERR 完成
+  return Reply_awaiter<DWORD>(
+      nullptr, nullptr, CAN_OBJ{}, {REPLY_NONE, 0, 0, 0}, 0,
+      [](DWORD status, const CAN_OBJ &) { return status; });
+}
+
+template <EcanVci::Can_backend Backend>
+Motor_core::status_type Basic_motor_control<Backend>::SetZero() const {
   // 设为零位的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[4] = {id_high, id_low, 0x00, 0x03};
-  can_transport.Transmit(0x7FF, data, 4);
-  return 0;
+  CAN_OBJ msg;
+  EncodeSetting(msg, 0x03);
+  return SendCmd(msg);
 }
 
-Motor_control::status_type Motor_control::ResetID() {
-  // 重置ID的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[6] = {0x7F, 0x7F, 0x00, 0x05, 0x7F, 0x7F};
-  can_transport.Transmit(0x7FF, data, 6);
-  return 0;
+template <EcanVci::Can_backend Backend>
+Motor_core::status_type Basic_motor_control<Backend>::ResetID() {
+  // 重置ID的具体实现，广播到所有电机
+  CAN_OBJ msg;
+  EncodeResetIDBroadcast(msg);
+  return SendCmd(msg);
 }
 
-Motor_control::status_type Motor_control::ResetID(uint16_t new_id) {
+template <EcanVci::Can_backend Backend>
+Motor_core::status_type Basic_motor_control<Backend>::ResetID(uint16_t new_id) {
   // 重置ID的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[6] = {id_high,
-                     id_low,
-                     0x00,
-                     0x04,
-                     static_cast<uint8_t>(new_id >> 8),
-                     static_cast<uint8_t>(new_id & 0xFF)};
-  can_transport.Transmit(0x7FF, data, 6);
-  return 0;
+  CAN_OBJ msg;
+  EncodeResetID(msg, new_id);
+  status_type result = SendCmd(msg);
+  if (result == STATUS_OK) {
+    ChangeID(new_id);
+  }
+  return result;
 }
 
-Motor_control::status_type Motor_control::ResetID(uint8_t new_id_high,
-                                                  uint8_t new_id_low) {
+template <EcanVci::Can_backend Backend>
+Motor_core::status_type
+Basic_motor_control<Backend>::ResetID(uint8_t new_id_high, uint8_t new_id_low) {
   // 重置ID的具体实现
-  // 示例：发送CAN命令
   uint16_t new_id = (new_id_high << 8) | new_id_low;
   return ResetID(new_id);
 }
 
-Motor::Communication_mode Motor_control::QueryCommunicationMode() {
-  // 查询通信模式的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[4] = {id_high, id_low, 0x00, 0x81};
-  can_transport.Transmit(0x7FF, data, 4);
+template <EcanVci::Can_backend Backend>
+Motor_core::status_type Basic_motor_control<Backend>::SetCommunicationMode(
+    Communication_mode mode) const {
+  CAN_OBJ msg;
+  EncodeSetting(msg, static_cast<uint8_t>(mode));
+  return SendCmd(msg);
+}
+
+template <EcanVci::Can_backend Backend>
+Motor::Communication_mode
+Basic_motor_control<Backend>::QueryCommunicationMode() {
+  // 查询通信模式的具体实现，结果由反馈帧给出，见 QueryCommunicationModeAsync
+  CAN_OBJ msg;
+  EncodeSetting(msg, 0x81);
+  SendCmd(msg);
   return Motor::Communication_mode::UNKOWN;
 }
 
-uint16_t Motor_control::QueryID() const {
-  // 查询ID的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[4] = {0xFF, 0xFF, 0x00, 0x82};
-  can_transport.Transmit(0x7FF, data, 4);
-  // TODO complite receive
-  // ...
-  return 0;
+template <EcanVci::Can_backend Backend>
+uint16_t Basic_motor_control<Backend>::QueryID() const {
+  return QueryID(can_transport);
 }
 
-uint16_t Motor_control::QueryID(const EcanVci::Can_transport &can_transport) {
-  // 查询ID的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[4] = {0xFF, 0xFF, 0x00, 0x82};
-  can_transport.Transmit(0x7FF, data, 4);
+template <EcanVci::Can_backend Backend>
+uint16_t Basic_motor_control<Backend>::QueryID(const Backend &can_transport) {
+  // 查询ID的具体实现，结果由反馈帧给出，见 QueryIDAsync
+  CAN_OBJ msg;
+  EncodeQueryID(msg);
+  can_transport.Transmit(&msg, 1);
   // TODO complite receive
   // ...
   return 0;
 }
 
-void Motor_control::HybridControl(Motor::PID_parameters pid, float position,
-                                  float speed, float current) const {
-  // 混合控制的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[8];
-  // 将pid, position, speed, current转换为CAN数据
-  // ...
-  can_transport.Transmit((id_high << 8) | id_low, data, 8);
+template <EcanVci::Can_backend Backend>
+void Basic_motor_control<Backend>::HybridControl(Motor::PID_parameters pid,
+                                                 float position, float speed,
+                                                 float current) const {
+  // 混合控制的具体实现，只使用 kp 与 kd，current 为前馈力矩
+  CAN_OBJ &msg = frames[FRAME_HYBRID];
+  {
+    MOTOR_PROFILE_SCOPE(PHASE_ENCODE);
+    model.EncodeHybrid(msg, pid.kp, pid.kd, position, speed, current);
+  }
+  SendCmd(msg);
+}
+
+template <EcanVci::Can_backend Backend>
+void Basic_motor_control<Backend>::SetPosition(
+    float position, uint16_t speed, uint16_t current,
+    Message_return_status ack_status) const {
+  // 设置位置的具体实现，应答类型只支持 0~3
+  if (ack_status > ACK_TYPE_3) {
+    return;
+  }
+  CAN_OBJ &msg = frames[FRAME_POSITION];
+  PatchPosition(msg, position, speed, current, ack_status);
+  SendCmd(msg);
+}
+
+template <EcanVci::Can_backend Backend>
+void Basic_motor_control<Backend>::SetSpeed(
+    float speed, uint16_t current, Message_return_status ack_status) const {
+  // 设置速度的具体实现
+  CAN_OBJ &msg = frames[FRAME_SPEED];
+  PatchSpeed(msg, speed, current, ack_status);
+  SendCmd(msg);
+}
+
+template <EcanVci::Can_backend Backend>
+void Basic_motor_control<Backend>::SetCurrent(
+    uint16_t current, Message_return_status ack_status) const {
+  // 设置电流的具体实现
+  CAN_OBJ &msg = frames[FRAME_CURRENT];
+  PatchCurrent(msg, current, ack_status);
+  SendCmd(msg);
+}
+
+template <EcanVci::Can_backend Backend>
+void Basic_motor_control<Backend>::ControlWithMode(
+    Control_mode control_mode, float current_or_torque,
+    Message_return_status ack_status) const {
+  // 以指定模式控制的具体实现，应答类型只支持 0~3
+  if (ack_status > ACK_TYPE_3) {
+    return;
+  }
+  CAN_OBJ &msg = frames[FRAME_CURRENT];
+  PatchControlWithMode(msg, control_mode, current_or_torque, ack_status);
+  SendCmd(msg);
+}
+
+template <EcanVci::Can_backend Backend>
+void Basic_motor_control<Backend>::SetAcceleration(
+    uint16_t acceleration, Message_return_status ack_status) const {
+  // 应答类型只支持 0~2
+  if (ack_status > ACK_TYPE_2) {
+    return;
+  }
+  CAN_OBJ msg;
+  EncodeParameter(msg, 0x01, std::min(acceleration, ACCELERATION_MAX), 0,
+                  ack_status);
+  SendCmd(msg);
+}
+
+template <EcanVci::Can_backend Backend>
+void Basic_motor_control<Backend>::SetLinkageSpeedKI(
+    uint16_t linkage_kp, uint16_t speed_ki,
+    Message_return_status ack_status) const {
+  if (ack_status > ACK_TYPE_2) {
+    return;
+  }
+  CAN_OBJ msg;
+  EncodeParameter(msg, 0x02, std::min(linkage_kp, GAIN_MAX),
+                  std::min(speed_ki, GAIN_MAX), ack_status);
+  SendCmd(msg);
+}
+
+template <EcanVci::Can_backend Backend>
+void Basic_motor_control<Backend>::SetFeedbackKPKD(
+    uint16_t feedback_kp, uint16_t feedback_kd,
+    Message_return_status ack_status) const {
+  if (ack_status > ACK_TYPE_2) {
+    return;
+  }
+  CAN_OBJ msg;
+  EncodeParameter(msg, 0x03, std::min(feedback_kp, GAIN_MAX),
+                  std::min(feedback_kd, GAIN_MAX), ack_status);
+  SendCmd(msg);
+}
+
+template <EcanVci::Can_backend Backend>
+void Basic_motor_control<Backend>::GetParameter(Parameter_code code) const {
+  CAN_OBJ msg;
+  EncodeGetParameter(msg, code);
+  SendCmd(msg);
 }
 
-void Motor_control::SetPosition(float position, uint16_t speed,
+CAN_OBJ *Motor_core::StagePosition(Frame_batch &batch, float position,
+                                   uint16_t speed, uint16_t current,
+                                   Message_return_status ack_status) const {
+  if (ack_status > ACK_TYPE_3) {
+    return nullptr;
+  }
+  CAN_OBJ *msg = batch.Acquire(this, FRAME_POSITION, templates[FRAME_POSITION]);
+  if (msg) {
+    PatchPosition(*msg, position, speed, current, ack_status);
+  }
+  return msg;
+}
+
+CAN_OBJ *Motor_core::StageSpeed(Frame_batch &batch, float speed,
                                 uint16_t current,
                                 Message_return_status ack_status) const {
-  // 设置位置的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[8];
-  // 将position, speed, current, ack_status转换为CAN数据
-  // ...
-  can_transport.Transmit((id_high << 8) | id_low, data, 8);
+  CAN_OBJ *msg = batch.Acquire(this, FRAME_SPEED, templates[FRAME_SPEED]);
+  if (msg) {
+    PatchSpeed(*msg, speed, current, ack_status);
+  }
+  return msg;
 }
 
-void Motor_control::SetSpeed(float speed, uint16_t current,
+CAN_OBJ *Motor_core::StageCurrent(Frame_batch &batch, uint16_t current,
+                                  Message_return_status ack_status) const {
+  CAN_OBJ *msg = batch.Acquire(this, FRAME_CURRENT, templates[FRAME_CURRENT]);
+  if (msg) {
+    PatchCurrent(*msg, current, ack_status);
+  }
+  return msg;
+}
+
+CAN_OBJ *
+Motor_core::StageControlWithMode(Frame_batch &batch, Control_mode control_mode,
+                                 float current_or_torque,
+                                 Message_return_status ack_status) const {
+  if (ack_status > ACK_TYPE_3) {
+    return nullptr;
+  }
+  CAN_OBJ *msg = batch.Acquire(this, FRAME_CURRENT, templates[FRAME_CURRENT]);
+  if (msg) {
+    PatchControlWithMode(*msg, control_mode, current_or_torque, ack_status);
+  }
+  return msg;
+}
+
+CAN_OBJ *Motor_core::StageHybrid(Frame_batch &batch, float kp, float kd,
+                                 float position, float speed,
+                                 float torque) const {
+  CAN_OBJ *msg = batch.Acquire(this, FRAME_HYBRID, templates[FRAME_HYBRID]);
+  if (msg) {
+    MOTOR_PROFILE_SCOPE(PHASE_ENCODE);
+    model.EncodeHybrid(*msg, kp, kd, position, speed, torque);
+  }
+  return msg;
+}
+
+Reply_awaiter<DWORD> Motor_core::SetZeroAsync() const {
+  CAN_OBJ msg;
+  EncodeSetting(msg, 0x03);
+  return AwaitReply(msg, {REPLY_MANAGEMENT, 0, ID(), 0x7FF});
+}
+
+Task<DWORD> Motor_core::ResetIDAsync(uint16_t new_id) {
+  // 新ID生效后以新ID反馈
+  CAN_OBJ msg;
+  EncodeResetID(msg, new_id);
+  DWORD result = co_await AwaitReply(msg, {REPLY_MANAGEMENT, 0, new_id, 0x7FF});
+  if (result == STATUS_OK) {
+    ChangeID(new_id);
+  }
+  co_return result;
+}
+
+Reply_awaiter<DWORD> Motor_core::ResetIDAsync() const {
+  // 成功后以 0x7F7F 反馈
+  CAN_OBJ msg;
+  EncodeResetIDBroadcast(msg);
+  return AwaitReply(msg, {REPLY_MANAGEMENT, 0, MANAGEMENT_RESET_ID, 0x7FF});
+}
+
+Reply_awaiter<DWORD> Motor_core::AssignIDAsync(uint16_t current_id) const {
+  // 从当前 ID 发出改 ID 命令，新 ID 生效后以新 ID 反馈
+  CAN_OBJ msg;
+  EncodeResetID(msg, ID());
+  msg.Data[0] = static_cast<uint8_t>(current_id >> 8);
+  msg.Data[1] = static_cast<uint8_t>(current_id & 0xFF);
+  return AwaitReply(msg, {REPLY_MANAGEMENT, 0, ID(), 0x7FF});
+}
+
+Reply_awaiter<std::optional<uint16_t>> Motor_core::QueryIDAsync() const {
+  CAN_OBJ msg;
+  EncodeQueryID(msg);
+  return Reply_awaiter<std::optional<uint16_t>>(
+      executor, this, msg, {REPLY_MANAGEMENT, 0, MANAGEMENT_ID_QUERY, 0x7FF},
+      max_retry_times,
+      [](DWORD status, const CAN_OBJ &reply) -> std::optional<uint16_t> {
+        if (status != STATUS_OK || reply.DataLen < 5 ||
+            Reply_match::ManagementID(reply) != MANAGEMENT_ID_QUERY) {
+          return std::nullopt;
+        }
+        return static_cast<uint16_t>(reply.Data[3] << 8 | reply.Data[4]);
+      });
+}
+
+Reply_awaiter<DWORD>
+Motor_core::SetCommunicationModeAsync(Communication_mode mode) const {
+  CAN_OBJ msg;
+  EncodeSetting(msg, static_cast<uint8_t>(mode));
+  return AwaitReply(msg, {REPLY_MANAGEMENT, 0, ID(), 0x7FF});
+}
+
+Reply_awaiter<Communication_mode>
+Motor_core::QueryCommunicationModeAsync() const {
+  CAN_OBJ msg;
+  EncodeSetting(msg, 0x81);
+  return Reply_awaiter<Communication_mode>(
+      executor, this, msg, {REPLY_MANAGEMENT, 0, ID(), 0x7FF},
+      max_retry_times,
+      [](DWORD status, const CAN_OBJ &reply) {
+        return status == STATUS_OK
+                   ? static_cast<Communication_mode>(reply.Data[3])
+                   : Communication_mode::UNKOWN;
+      });
+}
+
+Reply_awaiter<DWORD>
+Motor_core::SetPositionAsync(float position, uint16_t speed, uint16_t current,
                              Message_return_status ack_status) const {
-  // 设置速度的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[7];
-  // 将speed, current, ack_status转换为CAN数据
-  uint32_t speed_bytes = *static_cast<uint32_t *>(static_cast<void *>(&speed));
+  CAN_OBJ msg;
+  EncodePosition(msg, position, speed, current, ack_status);
+  return AwaitAck(msg, ack_status);
+}
 
-  data[0] = 0x40 | static_cast<uint8_t>(ack_status);
-  data[1] = 0xff & static_cast<uint8_t>(speed_bytes >> 24);
-  data[2] = 0xff & static_cast<uint8_t>(speed_bytes >> 16);
-  data[3] = 0xff & static_cast<uint8_t>(speed_bytes >> 8);
-  data[4] = 0xff & static_cast<uint8_t>(speed_bytes);
-  data[5] = 0xff & static_cast<uint8_t>(current >> 8);
-  data[6] = 0xff & static_cast<uint8_t>(current);
+Reply_awaiter<DWORD>
+Motor_core::SetSpeedAsync(float speed, uint16_t current,
+                          Message_return_status ack_status) const {
+  CAN_OBJ msg;
+  EncodeSpeed(msg, speed, current, ack_status);
+  return AwaitAck(msg, ack_status);
+}
 
-  can_transport.Transmit((id_high << 8) | id_low, data, 7);
+Reply_awaiter<DWORD>
+Motor_core::SetCurrentAsync(uint16_t current,
+                            Message_return_status ack_status) const {
+  CAN_OBJ msg;
+  EncodeCurrent(msg, current, ack_status);
+  return AwaitAck(msg, ack_status);
 }
 
-void Motor_control::SetCurrent(uint16_t current,
-                               Message_return_status ack_status) const {
-  // 设置电流的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[3];
-  // 将current, ack_status转换为CAN数据
-  data[0] = 0x60 | static_cast<uint8_t>(ack_status);
-  data[1] = 0xff & static_cast<uint8_t>(current >> 8);
-  data[2] = 0xff & static_cast<uint8_t>(current);
-
-  can_transport.Transmit((id_high << 8) | id_low, data, 3);
-}
-
-void Motor_control::ControlWithMode(Control_mode control_mode,
-                                    float current_or_torque,
-                                    Message_return_status ack_status) const {
-  // 以指定模式控制的具体实现
-  // 示例：发送CAN命令
-  uint8_t data[3];
-  // 将control_mode, current_or_torque, ack_status转换为CAN数据
-  // ...
-  can_transport.Transmit((id_high << 8) | id_low, data, 3);
+Reply_awaiter<DWORD>
+Motor_core::ControlWithModeAsync(Control_mode control_mode,
+                                 float current_or_torque,
+                                 Message_return_status ack_status) const {
+  CAN_OBJ msg;
+  EncodeControlWithMode(msg, control_mode, current_or_torque, ack_status);
+  return AwaitAck(msg, ack_status);
+}
+
+Reply_awaiter<DWORD>
+Motor_core::SetAccelerationAsync(uint16_t acceleration,
+                                 Message_return_status ack_status) const {
+  // 应答类型只支持 0~2
+  if (ack_status > ACK_TYPE_2) {
+    return RejectReply();
+  }
+  CAN_OBJ msg;
+  EncodeParameter(msg, 0x01, std::min(acceleration, ACCELERATION_MAX), 0,
+                  ack_status);
+  return AwaitAck(msg, ack_status);
 }
 
+Reply_awaiter<DWORD>
+Motor_core::SetLinkageSpeedKIAsync(uint16_t linkage_kp, uint16_t speed_ki,
+                                   Message_return_status ack_status) const {
+  // 应答类型只支持 0~2
+  if (ack_status > ACK_TYPE_2) {
+    return RejectReply();
+  }
+  CAN_OBJ msg;
+  EncodeParameter(msg, 0x02, std::min(linkage_kp, GAIN_MAX),
+                  std::min(speed_ki, GAIN_MAX), ack_status);
+  return AwaitAck(msg, ack_status);
+}
+
+Reply_awaiter<DWORD>
+Motor_core::SetFeedbackKPKDAsync(uint16_t feedback_kp, uint16_t feedback_kd,
+                                 Message_return_status ack_status) const {
+  // 应答类型只支持 0~2
+  if (ack_status > ACK_TYPE_2) {
+    return RejectReply();
+  }
+  CAN_OBJ msg;
+  EncodeParameter(msg, 0x03, std::min(feedback_kp, GAIN_MAX),
+                  std::min(feedback_kd, GAIN_MAX), ack_status);
+  return AwaitAck(msg, ack_status);
+}
+
+Reply_awaiter<std::optional<float>>
+Motor_core::GetParameterAsync(Parameter_code code) const {
+  CAN_OBJ msg;
+  EncodeGetParameter(msg, code);
+  return Reply_awaiter<std::optional<float>>(
+      executor, this, msg, {REPLY_ACK, ACK_TYPE_5, 0, ID(), code},
+      max_retry_times,
+      [](DWORD status, const CAN_OBJ &reply) -> std::optional<float> {
+        Parameter_code code;
+        return status == STATUS_OK ? DecodeParameter(reply, code)
+                                   : std::nullopt;
+      });
+}
+
+template class Basic_motor_control<EcanVci::Can_transport>;
+template class Basic_motor_control<EcanVci::Can_backend_handle>;
+template class Basic_motor_control<Motord::Motord_client>;
+template class Basic_motor_control<EcanVci::Socket_can_transport>;
+template class Basic_motor_control<EcanVci::Receive_engine>;
+
 } // namespace Motor
@@ -0,0 +1,191 @@
+/**
+ * @file Motord_client.cpp
+ * @brief 实现 Motord.hpp 中的客户端
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Logger.hpp"
+#include "Motord.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace Motord {
+
+static_assert(EcanVci::Can_backend<Motord_client>);
+
+namespace {
+
+Motord_request MakeRequest(Request_type type, uint32_t channel,
+                           const std::vector<uint16_t> &ids) {
+  if (ids.size() > MAX_FILTER_IDS) {
+    throw std::invalid_argument("Too many filter IDs");
+  }
+  Motord_request request = {};
+  request.magic = PROTOCOL_MAGIC;
+  request.type = type;
+  request.channel = channel;
+  request.id_count = static_cast<uint32_t>(ids.size());
+  std::copy(ids.begin(), ids.end(), request.ids);
+  return request;
+}
+
+} // namespace
+
+Motord_client::Motord_client(uint32_t channel,
+                             const std::vector<uint16_t> &ids,
+                             const char *socket_path)
+    : region(nullptr), reported_dropped(0) {
+  socket_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (socket_fd < 0) {
+    throw std::runtime_error("Create motord socket failed");
+  }
+  sockaddr_un address = {};
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+  if (connect(socket_fd, reinterpret_cast<sockaddr *>(&address),
+              sizeof(address)) != 0) {
+    close(socket_fd);
+    LOG_ERROR("Connect motord failed: {}", socket_path);
+    throw std::runtime_error("Connect motord failed");
+  }
+
+  int fd = -1;
+  if (!Request(MakeRequest(REQUEST_ATTACH, channel, ids), &fd) || fd < 0) {
+    close(socket_fd);
+    throw std::runtime_error("Attach motord channel failed");
+  }
+  void *base = mmap(nullptr, sizeof(Motord_region), PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    close(socket_fd);
+    throw std::runtime_error("Map motord region failed");
+  }
+  region = static_cast<Motord_region *>(base);
+  LOG_INFO("Attached motord channel {}", channel);
+}
+
+Motord_client::~Motord_client() {
+  if (region) {
+    munmap(region, sizeof(Motord_region));
+  }
+  close(socket_fd);
+}
+
+bool Motord_client::Request(const Motord_request &request, int *fd) const {
+  if (send(socket_fd, &request, sizeof(request), MSG_NOSIGNAL) !=
+      sizeof(request)) {
+    return false;
+  }
+
+  Motord_response response;
+  iovec iov = {&response, sizeof(response)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  msghdr message = {};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  if (recvmsg(socket_fd, &message, MSG_CMSG_CLOEXEC) != sizeof(response) ||
+      response.magic != PROTOCOL_MAGIC) {
+    return false;
+  }
+
+  cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+  if (fd && cmsg && cmsg->cmsg_level == SOL_SOCKET &&
+      cmsg->cmsg_type == SCM_RIGHTS) {
+    memcpy(fd, CMSG_DATA(cmsg), sizeof(int));
+  }
+  return response.status == STATUS_OK;
+}
+
+bool Motord_client::SetFilter(const std::vector<uint16_t> &ids) const {
+  return Request(MakeRequest(REQUEST_SET_FILTER, 0, ids));
+}
+
+uint64_t Motord_client::DroppedCount() const {
+  return region->rx_dropped.load(std::memory_order_relaxed);
+}
+
+DWORD Motord_client::ReadError(ERR_INFO &error) const {
+  error = {};
+  uint64_t dropped = DroppedCount();
+  if (dropped != reported_dropped) {
+    error.ErrCode = ERR_BUFFEROVERFLOW;
+    reported_dropped = dropped;
+  }
+  return STATUS_OK;
+}
+
+DWORD Motord_client::Transmit(CAN_OBJ msgs[], ULONG len) const {
+  return region->tx.Push(msgs, len);
+}
+
+DWORD Motord_client::Receive(CAN_OBJ msgs[], ULONG len, INT wait_time) const {
+  DWORD count = region->rx.Pop(msgs, len);
+  if (count > 0 || wait_time <= 0) {
+    return count;
+  }
+  auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(wait_time);
+  while (std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::microseconds(20));
+    count = region->rx.Pop(msgs, len);
+    if (count > 0) {
+      break;
+    }
+  }
+  return count;
+}
+
+DWORD Motord_client::Transmit(UINT destination, BYTE data[], ULONG len) const {
+  if (len > 8) {
+    LOG_ERROR("Data length should be less than or equal to 8");
+    throw std::runtime_error("Data length should be less than or equal to 8");
+  }
+  CAN_OBJ msg{};
+  msg.ID = destination;
+  msg.DataLen = static_cast<BYTE>(len);
+  memcpy(msg.Data, data, len);
+  if (Transmit(&msg, 1) != 1) {
+    LOG_ERROR("Transmit failed");
+    throw std::runtime_error("Transmit failed");
+  }
+  return 1;
+}
+
+DWORD Motord_client::ReceiveOnce(UINT &source, BYTE data[], ULONG &len,
+                                 ULONG wait_time) const {
+  CAN_OBJ msg;
+  if (Receive(&msg, 1, wait_time) == 0) {
+    return STATUS_ERR;
+  }
+  source = msg.ID;
+  len = msg.DataLen;
+  memcpy(data, msg.Data, len);
+  return 1;
+}
+
+DWORD Motord_client::ReceiveLast(UINT &source, BYTE data[], ULONG &len,
+                                 ULONG wait_time) const {
+  CAN_OBJ msg[100];
+  auto result = Receive(msg, 100, wait_time);
+  if (result == 0) {
+    return STATUS_ERR;
+  }
+  source = msg[result - 1].ID;
+  len = msg[result - 1].DataLen;
+  memcpy(data, msg[result - 1].Data, len);
+  return result;
+}
+
+} // namespace Motord
@@ -0,0 +1,250 @@
+/**
+ * @file Parameter_manager.cpp
+ * @brief 实现 Parameter_manager.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Parameter_manager.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace Motor {
+
+namespace {
+
+// 同一条设置指令写入的参数，second 为 PARAM_POSITION 表示只有一个参数
+struct Parameter_group {
+  Parameter_code first, second;
+  uint16_t max;
+};
+
+constexpr Parameter_group GROUPS[] = {
+    {PARAM_ACCELERATION, PARAM_POSITION, ACCELERATION_MAX},
+    {PARAM_LINKAGE_KP, PARAM_SPEED_KI, GAIN_MAX},
+    {PARAM_FEEDBACK_KP, PARAM_FEEDBACK_KD, GAIN_MAX},
+};
+
+std::optional<uint16_t> Target(const Tuning_profile &profile,
+                               Parameter_code code) {
+  switch (code) {
+  case PARAM_ACCELERATION:
+    return profile.acceleration;
+  case PARAM_LINKAGE_KP:
+    return profile.linkage_kp;
+  case PARAM_SPEED_KI:
+    return profile.speed_ki;
+  case PARAM_FEEDBACK_KP:
+    return profile.feedback_kp;
+  case PARAM_FEEDBACK_KD:
+    return profile.feedback_kd;
+  default:
+    return std::nullopt;
+  }
+}
+
+} // namespace
+
+Parameter_manager::Parameter_manager(Async_executor &executor, uint32_t window)
+    : executor(executor), window(window), profile({}), verify(true),
+      next_entry(0), failed_count(0), written_count(0), skipped_count(0) {
+  if (window == 0) {
+    throw std::runtime_error("Parameter window must be positive");
+  }
+}
+
+void Parameter_manager::Add(Motor_core &motor) {
+  if (Find(motor) != nullptr) {
+    throw std::runtime_error("Motor already added");
+  }
+  entries.push_back({&motor, {}});
+}
+
+Parameter_manager::Entry *Parameter_manager::Find(const Motor_core &motor) {
+  auto it = std::find_if(entries.begin(), entries.end(),
+                         [&](const Entry &e) { return e.motor == &motor; });
+  return it == entries.end() ? nullptr : &*it;
+}
+
+const Parameter_manager::Entry *
+Parameter_manager::Find(const Motor_core &motor) const {
+  return const_cast<Parameter_manager *>(this)->Find(motor);
+}
+
+std::optional<uint16_t>
+Parameter_manager::Cached(const Motor_core &motor,
+                          Parameter_code code) const {
+  const Entry *entry = Find(motor);
+  if (entry == nullptr || code >= entry->cache.size()) {
+    return std::nullopt;
+  }
+  return entry->cache[code];
+}
+
+void Parameter_manager::Invalidate() {
+  for (Entry &entry : entries) {
+    entry.cache.fill(std::nullopt);
+  }
+}
+
+Task<std::optional<uint16_t>> Parameter_manager::Read(Entry &entry,
+                                                     Parameter_code code) {
+  std::optional<float> value = co_await entry.motor->GetParameterAsync(code);
+  if (!value) {
+    entry.cache[code].reset();
+    co_return std::nullopt;
+  }
+  entry.cache[code] = static_cast<uint16_t>(*value);
+  co_return entry.cache[code];
+}
+
+Task<DWORD> Parameter_manager::Upload(Entry &entry) {
+  Motor_core &motor = *entry.motor;
+  Message_return_status ack_status = verify ? NO_ACK : ACK_TYPE_1;
+  std::optional<uint16_t> expected[PARAM_FEEDBACK_KD + 1];
+
+  for (const Parameter_group &group : GROUPS) {
+    bool paired = group.second != PARAM_POSITION;
+    std::optional<uint16_t> first = Target(profile, group.first);
+    std::optional<uint16_t> second = Target(profile, group.second);
+    if (!first && !second) {
+      continue;
+    }
+    if (first) {
+      first = std::min(*first, group.max);
+    }
+    if (second) {
+      second = std::min(*second, group.max);
+    }
+
+    // 成对写入的参数只给出一个时，另一个沿用电机上的当前值
+    if (!first) {
+      first = entry.cache[group.first];
+      if (!first && !(first = co_await Read(entry, group.first))) {
+        co_return STATUS_ERR;
+      }
+    }
+    if (paired && !second) {
+      second = entry.cache[group.second];
+      if (!second && !(second = co_await Read(entry, group.second))) {
+        co_return STATUS_ERR;
+      }
+    }
+
+    if (entry.cache[group.first] == first &&
+        (!paired || entry.cache[group.second] == second)) {
+      skipped_count++;
+      continue;
+    }
+
+    DWORD status = STATUS_ERR;
+    switch (group.first) {
+    case PARAM_ACCELERATION:
+      status = co_await motor.SetAccelerationAsync(*first, ack_status);
+      break;
+    case PARAM_LINKAGE_KP:
+      status = co_await motor.SetLinkageSpeedKIAsync(*first, *second,
+                                                     ack_status);
+      break;
+    default:
+      status = co_await motor.SetFeedbackKPKDAsync(*first, *second,
+                                                   ack_status);
+      break;
+    }
+    if (status != STATUS_OK) {
+      entry.cache[group.first].reset();
+      if (paired) {
+        entry.cache[group.second].reset();
+      }
+      co_return STATUS_ERR;
+    }
+    written_count++;
+
+    if (verify) {
+      // 回读确认前缓存视为未知
+      entry.cache[group.first].reset();
+      expected[group.first] = first;
+      if (paired) {
+        entry.cache[group.second].reset();
+        expected[group.second] = second;
+      }
+    } else {
+      entry.cache[group.first] = first;
+      if (paired) {
+        entry.cache[group.second] = second;
+      }
+    }
+  }
+
+  for (uint8_t code = PARAM_ACCELERATION; code <= PARAM_FEEDBACK_KD; code++) {
+    if (!expected[code]) {
+      continue;
+    }
+    std::optional<uint16_t> value =
+        co_await Read(entry, static_cast<Parameter_code>(code));
+    if (value != expected[code]) {
+      LOG_WARN("Motor {} parameter {} verify failed: expected {} got {}",
+               motor.ID(), code, *expected[code],
+               value ? static_cast<int>(*value) : -1);
+      co_return STATUS_ERR;
+    }
+  }
+  co_return STATUS_OK;
+}
+
+Task<DWORD> Parameter_manager::Refresh(Entry &entry) {
+  for (uint8_t code = PARAM_ACCELERATION; code <= PARAM_FEEDBACK_KD; code++) {
+    if (!co_await Read(entry, static_cast<Parameter_code>(code))) {
+      co_return STATUS_ERR;
+    }
+  }
+  co_return STATUS_OK;
+}
+
+Task<void> Parameter_manager::Worker(Job job) {
+  // 各工作协程从同一个下标取电机，执行器单线程运行，无需同步
+  while (next_entry < entries.size()) {
+    Entry &entry = entries[next_entry++];
+    if (co_await (this->*job)(entry) != STATUS_OK) {
+      failed_count++;
+    }
+  }
+}
+
+void Parameter_manager::Schedule(Job job) {
+  next_entry = 0;
+  failed_count = written_count = skipped_count = 0;
+  uint32_t workers = std::min<size_t>(window, entries.size());
+  for (uint32_t i = 0; i < workers; i++) {
+    executor.Spawn(Worker(job));
+  }
+}
+
+void Parameter_manager::ScheduleApply(const Tuning_profile &profile,
+                                      bool verify) {
+  this->profile = profile;
+  this->verify = verify;
+  Schedule(&Parameter_manager::Upload);
+}
+
+void Parameter_manager::ScheduleRefresh() {
+  Schedule(&Parameter_manager::Refresh);
+}
+
+uint32_t Parameter_manager::Apply(const Tuning_profile &profile, bool verify) {
+  ScheduleApply(profile, verify);
+  executor.Run();
+  LOG_INFO("Parameters applied to {} motors: {} writes, {} skipped, {} failed",
+           entries.size(), written_count, skipped_count, failed_count);
+  return failed_count;
+}
+
+uint32_t Parameter_manager::Refresh() {
+  ScheduleRefresh();
+  executor.Run();
+  return failed_count;
+}
+
+} // namespace Motor
@@ -0,0 +1,368 @@
+/**
+ * @file Profiler.cpp
+ * @brief 实现 Profiler.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Profiler.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if PROFILE_X86
+#include <cpuid.h>
+#endif
+
+namespace Profile {
+
+namespace {
+
+bool DetectTsc() {
+#if PROFILE_X86
+  // CPUID 0x80000007 EDX bit 8：TSC 频率恒定且不随 C 状态停止
+  unsigned int eax, ebx, ecx, edx;
+  if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+    return (edx >> 8) & 1;
+  }
+#endif
+  return false;
+}
+
+// 对数分桶：小于 16 的值各占一桶，其余每个 2 的幂分 16 桶
+constexpr uint32_t SUB_BUCKETS = 16;
+constexpr uint32_t BUCKETS = (63 - 3) * SUB_BUCKETS + SUB_BUCKETS;
+
+uint32_t Bucket(uint64_t value) {
+  if (value < SUB_BUCKETS) {
+    return static_cast<uint32_t>(value);
+  }
+  uint32_t exponent = 63 - static_cast<uint32_t>(__builtin_clzll(value));
+  return (exponent - 3) * SUB_BUCKETS +
+         static_cast<uint32_t>((value >> (exponent - 4)) & (SUB_BUCKETS - 1));
+}
+
+uint64_t BucketUpper(uint32_t bucket) {
+  if (bucket < SUB_BUCKETS) {
+    return bucket;
+  }
+  uint32_t exponent = bucket / SUB_BUCKETS + 3;
+  uint64_t lower = (SUB_BUCKETS + bucket % SUB_BUCKETS) << (exponent - 4);
+  return lower + (1ULL << (exponent - 4)) - 1;
+}
+
+// 只由所属线程写入，其他线程读取时允许看到略旧的值
+void Add(std::atomic<uint64_t> &counter, uint64_t value) {
+  counter.store(counter.load(std::memory_order_relaxed) + value,
+                std::memory_order_relaxed);
+}
+
+struct Histogram {
+  std::atomic<uint64_t> buckets[BUCKETS];
+  std::atomic<uint64_t> count, sum, max;
+
+  void Clear() {
+    for (auto &bucket : buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+  }
+};
+
+struct Thread_state {
+  uint32_t thread_id;
+  Histogram phases[PHASE_COUNT];
+
+  // 当前周期，只由所属线程访问，时刻以 Ticks 为单位
+  uint64_t cycle_start = 0;
+  Cycle_record current = {};
+
+  // 最慢周期，以 Ticks 为单位，threshold 为已满时其中最短的耗时
+  std::mutex slowest_mutex;
+  std::vector<Cycle_record> slowest;
+  std::atomic<uint64_t> threshold{0};
+};
+
+class Registry {
+  std::mutex states_mutex;
+  std::vector<std::unique_ptr<Thread_state>> states;
+
+public:
+  const uint64_t tsc_base, raw_base;
+  std::atomic<uint32_t> slowest_count{8};
+
+  Registry() : tsc_base(Ticks()), raw_base(RawNow()) {}
+
+  Thread_state *Register() {
+    std::lock_guard<std::mutex> lock(states_mutex);
+    auto state = std::make_unique<Thread_state>();
+    state->thread_id = static_cast<uint32_t>(states.size());
+    for (auto &phase : state->phases) {
+      phase.Clear();
+    }
+    states.push_back(std::move(state));
+    return states.back().get();
+  }
+
+  template <typename F> void ForEach(F &&f) {
+    std::lock_guard<std::mutex> lock(states_mutex);
+    for (auto &state : states) {
+      f(*state);
+    }
+  }
+};
+
+Registry &Instance() {
+  static Registry registry;
+  return registry;
+}
+
+Thread_state &Local() {
+  thread_local Thread_state *state = Instance().Register();
+  return *state;
+}
+
+/**
+ * @brief 每 ns 的 Ticks 数，TSC 以启动以来与 CLOCK_MONOTONIC_RAW 的比值校准
+ */
+double TicksPerNs() {
+  if (!use_tsc) {
+    return 1.0;
+  }
+  Registry &registry = Instance();
+  uint64_t raw = RawNow();
+  if (raw - registry.raw_base < 10000000) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    raw = RawNow();
+  }
+  return static_cast<double>(Ticks() - registry.tsc_base) /
+         static_cast<double>(raw - registry.raw_base);
+}
+
+void Insert(Thread_state &state, uint64_t duration, uint32_t limit) {
+  std::lock_guard<std::mutex> lock(state.slowest_mutex);
+  state.current.thread_id = state.thread_id;
+  state.current.start = state.cycle_start;
+  state.current.duration = duration;
+  if (state.slowest.size() < limit) {
+    state.slowest.push_back(state.current);
+  } else {
+    auto shortest = std::min_element(
+        state.slowest.begin(), state.slowest.end(),
+        [](const Cycle_record &a, const Cycle_record &b) {
+          return a.duration < b.duration;
+        });
+    *shortest = state.current;
+  }
+  if (state.slowest.size() >= limit) {
+    state.threshold.store(
+        std::min_element(state.slowest.begin(), state.slowest.end(),
+                         [](const Cycle_record &a, const Cycle_record &b) {
+                           return a.duration < b.duration;
+                         })
+            ->duration,
+        std::memory_order_relaxed);
+  }
+}
+
+} // namespace
+
+const bool use_tsc = DetectTsc();
+
+const char *PhaseName(Phase phase) {
+  switch (phase) {
+  case PHASE_ENCODE:
+    return "encode";
+  case PHASE_TRANSMIT:
+    return "transmit";
+  case PHASE_RECEIVE:
+    return "receive";
+  case PHASE_DECODE:
+    return "decode";
+  case PHASE_USER:
+    return "user";
+  default:
+    return "unknown";
+  }
+}
+
+const char *ClockName() { return use_tsc ? "TSC" : "CLOCK_MONOTONIC_RAW"; }
+
+void Record(Phase phase, uint64_t start, uint64_t end) {
+  Thread_state &state = Local();
+  uint64_t duration = end > start ? end - start : 0;
+  Histogram &histogram = state.phases[phase];
+  Add(histogram.buckets[Bucket(duration)], 1);
+  Add(histogram.count, 1);
+  Add(histogram.sum, duration);
+  if (duration > histogram.max.load(std::memory_order_relaxed)) {
+    histogram.max.store(duration, std::memory_order_relaxed);
+  }
+
+  if (state.cycle_start == 0) {
+    return;
+  }
+  Cycle_record &current = state.current;
+  current.phase_time[phase] += duration;
+  current.phase_count[phase]++;
+  if (current.event_count < CYCLE_EVENTS) {
+    current.events[current.event_count++] = {
+        phase, start > state.cycle_start ? start - state.cycle_start : 0,
+        duration};
+  }
+}
+
+void EndCycle() {
+  Thread_state &state = Local();
+  uint64_t now = Ticks();
+  uint32_t limit = Instance().slowest_count.load(std::memory_order_relaxed);
+  if (state.cycle_start && limit) {
+    uint64_t duration = now - state.cycle_start;
+    // 未满或超过已保留的最短周期时才加锁插入
+    if (duration > state.threshold.load(std::memory_order_relaxed)) {
+      Insert(state, duration, limit);
+    }
+  }
+  state.current = {};
+  state.cycle_start = now;
+}
+
+void SetSlowestCount(uint32_t count) {
+  Instance().slowest_count.store(count, std::memory_order_relaxed);
+  Instance().ForEach([count](Thread_state &state) {
+    std::lock_guard<std::mutex> lock(state.slowest_mutex);
+    if (state.slowest.size() > count) {
+      std::sort(state.slowest.begin(), state.slowest.end(),
+                [](const Cycle_record &a, const Cycle_record &b) {
+                  return a.duration > b.duration;
+                });
+      state.slowest.resize(count);
+    }
+    state.threshold.store(0, std::memory_order_relaxed);
+  });
+}
+
+std::array<Phase_stats, PHASE_COUNT> Report() {
+  std::vector<uint64_t> buckets(BUCKETS);
+  std::array<Phase_stats, PHASE_COUNT> report = {};
+  double scale = 1.0 / TicksPerNs();
+
+  for (uint32_t phase = 0; phase < PHASE_COUNT; phase++) {
+    std::fill(buckets.begin(), buckets.end(), 0);
+    uint64_t count = 0, sum = 0, max = 0;
+    Instance().ForEach([&](Thread_state &state) {
+      const Histogram &histogram = state.phases[phase];
+      for (uint32_t i = 0; i < BUCKETS; i++) {
+        buckets[i] += histogram.buckets[i].load(std::memory_order_relaxed);
+      }
+      count += histogram.count.load(std::memory_order_relaxed);
+      sum += histogram.sum.load(std::memory_order_relaxed);
+      max = std::max(max, histogram.max.load(std::memory_order_relaxed));
+    });
+
+    Phase_stats &stats = report[phase];
+    stats.count = count;
+    if (count == 0) {
+      continue;
+    }
+    // 分位数取所在桶的上界，不超过最大值
+    auto percentile = [&](double fraction) {
+      uint64_t rank = static_cast<uint64_t>(fraction * (count - 1)) + 1;
+      uint64_t seen = 0;
+      for (uint32_t i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+          return std::min(BucketUpper(i), max) * scale;
+        }
+      }
+      return max * scale;
+    };
+    stats.mean = static_cast<double>(sum) / count * scale;
+    stats.p50 = percentile(0.50);
+    stats.p99 = percentile(0.99);
+    stats.max = max * scale;
+  }
+  return report;
+}
+
+std::vector<Cycle_record> Slowest() {
+  std::vector<Cycle_record> cycles;
+  Instance().ForEach([&](Thread_state &state) {
+    std::lock_guard<std::mutex> lock(state.slowest_mutex);
+    cycles.insert(cycles.end(), state.slowest.begin(), state.slowest.end());
+  });
+  std::sort(cycles.begin(), cycles.end(),
+            [](const Cycle_record &a, const Cycle_record &b) {
+              return a.duration > b.duration;
+            });
+
+  double ticks_per_ns = TicksPerNs();
+  Registry &registry = Instance();
+  auto to_ns = [ticks_per_ns](uint64_t ticks) {
+    return static_cast<uint64_t>(ticks / ticks_per_ns);
+  };
+  for (Cycle_record &cycle : cycles) {
+    cycle.start = registry.raw_base + to_ns(cycle.start - registry.tsc_base);
+    cycle.duration = to_ns(cycle.duration);
+    for (uint32_t phase = 0; phase < PHASE_COUNT; phase++) {
+      cycle.phase_time[phase] = to_ns(cycle.phase_time[phase]);
+    }
+    for (uint32_t i = 0; i < cycle.event_count; i++) {
+      cycle.events[i].start = to_ns(cycle.events[i].start);
+      cycle.events[i].duration = to_ns(cycle.events[i].duration);
+    }
+  }
+  return cycles;
+}
+
+void Dump(bool detail) {
+  LOG_INFO("Profile clock: {}", ClockName());
+  std::array<Phase_stats, PHASE_COUNT> report = Report();
+  for (uint32_t phase = 0; phase < PHASE_COUNT; phase++) {
+    const Phase_stats &stats = report[phase];
+    if (stats.count == 0) {
+      continue;
+    }
+    LOG_INFO("{}: count {} mean {} ns p50 {} ns p99 {} ns max {} ns",
+             PhaseName(static_cast<Phase>(phase)), stats.count,
+             static_cast<uint64_t>(stats.mean), static_cast<uint64_t>(stats.p50),
+             static_cast<uint64_t>(stats.p99), static_cast<uint64_t>(stats.max));
+  }
+
+  for (const Cycle_record &cycle : Slowest()) {
+    LOG_INFO("Slow cycle on thread {} at {} ns took {} ns", cycle.thread_id,
+             cycle.start, cycle.duration);
+    LOG_INFO("  encode {} transmit {} receive {} decode {} user {} ns",
+             cycle.phase_time[PHASE_ENCODE], cycle.phase_time[PHASE_TRANSMIT],
+             cycle.phase_time[PHASE_RECEIVE], cycle.phase_time[PHASE_DECODE],
+             cycle.phase_time[PHASE_USER]);
+    if (!detail) {
+      continue;
+    }
+    for (uint32_t i = 0; i < cycle.event_count; i++) {
+      const Cycle_event &event = cycle.events[i];
+      LOG_INFO("  +{} ns {} {} ns", event.start, PhaseName(event.phase),
+               event.duration);
+    }
+  }
+}
+
+void Reset() {
+  Instance().ForEach([](Thread_state &state) {
+    for (auto &phase : state.phases) {
+      phase.Clear();
+    }
+    std::lock_guard<std::mutex> lock(state.slowest_mutex);
+    state.slowest.clear();
+    state.threshold.store(0, std::memory_order_relaxed);
+  });
+}
+
+} // namespace Profile
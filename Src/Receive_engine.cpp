@@ -0,0 +1,97 @@
+/**
+ * @file Receive_engine.cpp
+ * @brief 实现 Receive_engine.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Receive_engine.hpp"
+#include "Logger.hpp"
+#include <cerrno>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace EcanVci {
+
+static_assert(Can_backend<Receive_engine>);
+
+Receive_engine::Receive_engine(Can_backend_handle backend, INT wait_time)
+    : backend(backend), wait_time(wait_time),
+      ring(std::make_unique<Spsc_ring<CAN_OBJ, RING_SIZE>>()), running(true),
+      dropped(0), reported_dropped(0) {
+  event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (event_fd < 0) {
+    LOG_ERROR("Create receive eventfd failed, errno {}", errno);
+    throw std::runtime_error("Create receive eventfd failed");
+  }
+  ring->Reset();
+  thread = std::thread(&Receive_engine::Loop, this);
+}
+
+Receive_engine::~Receive_engine() {
+  running.store(false, std::memory_order_relaxed);
+  thread.join();
+  close(event_fd);
+}
+
+void Receive_engine::Signal() const {
+  uint64_t one = 1;
+  [[maybe_unused]] ssize_t result = write(event_fd, &one, sizeof(one));
+}
+
+void Receive_engine::Loop() {
+  CAN_OBJ buffer[100];
+  while (running.load(std::memory_order_relaxed)) {
+    DWORD count = backend.Receive(buffer, 100, wait_time);
+    if (count == 0) {
+      continue;
+    }
+    uint32_t pushed = ring->Push(buffer, count);
+    if (pushed < count) {
+      dropped.fetch_add(count - pushed, std::memory_order_relaxed);
+      LOG_EVERY(Log::WARN, 1000, "Receive ring full, dropped {} frames",
+                count - pushed);
+    }
+    // 每批写一次 eventfd，消费者先清零再取帧，不会漏掉唤醒
+    Signal();
+  }
+}
+
+DWORD Receive_engine::Drain(CAN_OBJ msgs[], ULONG len) const {
+  uint64_t value;
+  [[maybe_unused]] ssize_t result = read(event_fd, &value, sizeof(value));
+  DWORD count = ring->Pop(msgs, len);
+  // 调用方一次没取完时保持可读
+  if (!ring->Empty()) {
+    Signal();
+  }
+  return count;
+}
+
+DWORD Receive_engine::Receive(CAN_OBJ msgs[], ULONG len,
+                              INT wait_time) const {
+  DWORD count = Drain(msgs, len);
+  if (count > 0 || wait_time <= 0) {
+    return count;
+  }
+  pollfd fd = {event_fd, POLLIN, 0};
+  if (poll(&fd, 1, wait_time) <= 0) {
+    return 0;
+  }
+  return Drain(msgs, len);
+}
+
+DWORD Receive_engine::ReadError(ERR_INFO &error) const {
+  DWORD status = backend.ReadError(error);
+  uint64_t count = DroppedCount();
+  if (count != reported_dropped) {
+    error.ErrCode |= ERR_BUFFEROVERFLOW;
+    reported_dropped = count;
+  }
+  return status;
+}
+
+} // namespace EcanVci
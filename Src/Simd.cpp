@@ -0,0 +1,316 @@
+/**
+ * @file Simd.cpp
+ * @brief 实现 Simd.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Simd.hpp"
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#define SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SIMD_X86 0
+#endif
+
+namespace Simd {
+
+namespace {
+
+Level Detect() {
+#if SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return LEVEL_AVX2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return LEVEL_SSE2;
+  }
+#endif
+  return LEVEL_SCALAR;
+}
+
+const Level supported = Detect();
+std::atomic<Level> selected{supported};
+
+void AffineScalar(const int32_t raw[], float out[], uint32_t len, float scale,
+                  float offset) {
+  for (uint32_t i = 0; i < len; i++) {
+    out[i] = static_cast<float>(raw[i]) * scale + offset;
+  }
+}
+
+void PidScalar(const Pid_arrays &a, uint32_t begin, uint32_t len, float dt) {
+  for (uint32_t i = begin; i < len; i++) {
+    float e = a.position_setpoint[i] - a.position[i];
+    float de = a.speed_setpoint[i] - a.speed[i];
+    float u = a.kp[i] * e + a.integral[i] + a.kd[i] * de + a.feedforward[i];
+    // 与 maxps/minps 的参数顺序一致：比较不成立（含 NaN）时取第二个操作数
+    float lower = u > a.output_min[i] ? u : a.output_min[i];
+    float out = lower < a.output_max[i] ? lower : a.output_max[i];
+    a.integral[i] += dt * (a.ki[i] * e + a.kaw[i] * (out - u));
+    a.output[i] = out;
+  }
+}
+
+void AlphaBetaScalar(const Alpha_beta_arrays &a, uint32_t begin,
+                     uint32_t len) {
+  for (uint32_t i = begin; i < len; i++) {
+    float predicted = a.position[i] + a.speed[i] * a.dt[i];
+    float r = a.measured_position[i] - predicted;
+    a.position[i] = predicted + a.position_gain[i] * r;
+    a.speed[i] = a.speed[i] + a.speed_gain[i] * r +
+                 a.speed_weight[i] * (a.measured_speed[i] - a.speed[i]);
+  }
+}
+
+void ExtrapolateScalar(const float position[], const float speed[],
+                       const float lead[], float out[], uint32_t len) {
+  for (uint32_t i = 0; i < len; i++) {
+    out[i] = position[i] + speed[i] * lead[i];
+  }
+}
+
+#if SIMD_X86
+
+SIMD_TARGET("sse2")
+void AffineSse2(const int32_t raw[], float out[], uint32_t len, float scale,
+                float offset) {
+  __m128 s = _mm_set1_ps(scale), o = _mm_set1_ps(offset);
+  uint32_t i = 0;
+  for (; i + 4 <= len; i += 4) {
+    __m128 x = _mm_cvtepi32_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + i)));
+    _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(x, s), o));
+  }
+  AffineScalar(raw + i, out + i, len - i, scale, offset);
+}
+
+// 不使用 FMA，保证与标量结果一致
+SIMD_TARGET("avx2")
+void AffineAvx2(const int32_t raw[], float out[], uint32_t len, float scale,
+                float offset) {
+  __m256 s = _mm256_set1_ps(scale), o = _mm256_set1_ps(offset);
+  uint32_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    __m256 x = _mm256_cvtepi32_ps(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(raw + i)));
+    _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(x, s), o));
+  }
+  // 尾部不调用 SSE2 版本，避免 AVX 与 SSE 指令切换的开销
+  AffineScalar(raw + i, out + i, len - i, scale, offset);
+}
+
+SIMD_TARGET("sse2")
+void PidSse2(const Pid_arrays &a, uint32_t len, float dt) {
+  __m128 t = _mm_set1_ps(dt);
+  uint32_t i = 0;
+  for (; i + 4 <= len; i += 4) {
+    __m128 e = _mm_sub_ps(_mm_loadu_ps(a.position_setpoint + i),
+                          _mm_loadu_ps(a.position + i));
+    __m128 de = _mm_sub_ps(_mm_loadu_ps(a.speed_setpoint + i),
+                           _mm_loadu_ps(a.speed + i));
+    __m128 integral = _mm_loadu_ps(a.integral + i);
+    __m128 u = _mm_add_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a.kp + i), e), integral),
+                   _mm_mul_ps(_mm_loadu_ps(a.kd + i), de)),
+        _mm_loadu_ps(a.feedforward + i));
+    __m128 out = _mm_min_ps(_mm_max_ps(u, _mm_loadu_ps(a.output_min + i)),
+                            _mm_loadu_ps(a.output_max + i));
+    __m128 step =
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(a.ki + i), e),
+                   _mm_mul_ps(_mm_loadu_ps(a.kaw + i), _mm_sub_ps(out, u)));
+    _mm_storeu_ps(a.integral + i, _mm_add_ps(integral, _mm_mul_ps(t, step)));
+    _mm_storeu_ps(a.output + i, out);
+  }
+  PidScalar(a, i, len, dt);
+}
+
+SIMD_TARGET("avx2")
+void PidAvx2(const Pid_arrays &a, uint32_t len, float dt) {
+  __m256 t = _mm256_set1_ps(dt);
+  uint32_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    __m256 e = _mm256_sub_ps(_mm256_loadu_ps(a.position_setpoint + i),
+                             _mm256_loadu_ps(a.position + i));
+    __m256 de = _mm256_sub_ps(_mm256_loadu_ps(a.speed_setpoint + i),
+                              _mm256_loadu_ps(a.speed + i));
+    __m256 integral = _mm256_loadu_ps(a.integral + i);
+    __m256 u = _mm256_add_ps(
+        _mm256_add_ps(
+            _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(a.kp + i), e),
+                          integral),
+            _mm256_mul_ps(_mm256_loadu_ps(a.kd + i), de)),
+        _mm256_loadu_ps(a.feedforward + i));
+    __m256 out =
+        _mm256_min_ps(_mm256_max_ps(u, _mm256_loadu_ps(a.output_min + i)),
+                      _mm256_loadu_ps(a.output_max + i));
+    __m256 step = _mm256_add_ps(
+        _mm256_mul_ps(_mm256_loadu_ps(a.ki + i), e),
+        _mm256_mul_ps(_mm256_loadu_ps(a.kaw + i), _mm256_sub_ps(out, u)));
+    _mm256_storeu_ps(a.integral + i,
+                     _mm256_add_ps(integral, _mm256_mul_ps(t, step)));
+    _mm256_storeu_ps(a.output + i, out);
+  }
+  PidScalar(a, i, len, dt);
+}
+
+SIMD_TARGET("sse2")
+void AlphaBetaSse2(const Alpha_beta_arrays &a, uint32_t len) {
+  uint32_t i = 0;
+  for (; i + 4 <= len; i += 4) {
+    __m128 position = _mm_loadu_ps(a.position + i);
+    __m128 speed = _mm_loadu_ps(a.speed + i);
+    __m128 predicted =
+        _mm_add_ps(position, _mm_mul_ps(speed, _mm_loadu_ps(a.dt + i)));
+    __m128 r = _mm_sub_ps(_mm_loadu_ps(a.measured_position + i), predicted);
+    _mm_storeu_ps(a.position + i,
+                  _mm_add_ps(predicted,
+                             _mm_mul_ps(_mm_loadu_ps(a.position_gain + i), r)));
+    __m128 blend =
+        _mm_mul_ps(_mm_loadu_ps(a.speed_weight + i),
+                   _mm_sub_ps(_mm_loadu_ps(a.measured_speed + i), speed));
+    _mm_storeu_ps(
+        a.speed + i,
+        _mm_add_ps(
+            _mm_add_ps(speed, _mm_mul_ps(_mm_loadu_ps(a.speed_gain + i), r)),
+            blend));
+  }
+  AlphaBetaScalar(a, i, len);
+}
+
+SIMD_TARGET("avx2")
+void AlphaBetaAvx2(const Alpha_beta_arrays &a, uint32_t len) {
+  uint32_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    __m256 position = _mm256_loadu_ps(a.position + i);
+    __m256 speed = _mm256_loadu_ps(a.speed + i);
+    __m256 predicted = _mm256_add_ps(
+        position, _mm256_mul_ps(speed, _mm256_loadu_ps(a.dt + i)));
+    __m256 r =
+        _mm256_sub_ps(_mm256_loadu_ps(a.measured_position + i), predicted);
+    _mm256_storeu_ps(
+        a.position + i,
+        _mm256_add_ps(predicted,
+                      _mm256_mul_ps(_mm256_loadu_ps(a.position_gain + i), r)));
+    __m256 blend =
+        _mm256_mul_ps(_mm256_loadu_ps(a.speed_weight + i),
+                      _mm256_sub_ps(_mm256_loadu_ps(a.measured_speed + i),
+                                    speed));
+    _mm256_storeu_ps(
+        a.speed + i,
+        _mm256_add_ps(
+            _mm256_add_ps(speed,
+                          _mm256_mul_ps(_mm256_loadu_ps(a.speed_gain + i), r)),
+            blend));
+  }
+  AlphaBetaScalar(a, i, len);
+}
+
+SIMD_TARGET("sse2")
+void ExtrapolateSse2(const float position[], const float speed[],
+                     const float lead[], float out[], uint32_t len) {
+  uint32_t i = 0;
+  for (; i + 4 <= len; i += 4) {
+    _mm_storeu_ps(out + i,
+                  _mm_add_ps(_mm_loadu_ps(position + i),
+                             _mm_mul_ps(_mm_loadu_ps(speed + i),
+                                        _mm_loadu_ps(lead + i))));
+  }
+  ExtrapolateScalar(position + i, speed + i, lead + i, out + i, len - i);
+}
+
+SIMD_TARGET("avx2")
+void ExtrapolateAvx2(const float position[], const float speed[],
+                     const float lead[], float out[], uint32_t len) {
+  uint32_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    _mm256_storeu_ps(out + i,
+                     _mm256_add_ps(_mm256_loadu_ps(position + i),
+                                   _mm256_mul_ps(_mm256_loadu_ps(speed + i),
+                                                 _mm256_loadu_ps(lead + i))));
+  }
+  ExtrapolateScalar(position + i, speed + i, lead + i, out + i, len - i);
+}
+
+#endif
+
+} // namespace
+
+Level GetLevel() { return selected.load(std::memory_order_relaxed); }
+
+void SetLevel(Level level) {
+  selected.store(level < supported ? level : supported,
+                 std::memory_order_relaxed);
+}
+
+const char *LevelName(Level level) {
+  switch (level) {
+  case LEVEL_AVX2:
+    return "AVX2";
+  case LEVEL_SSE2:
+    return "SSE2";
+  default:
+    return "scalar";
+  }
+}
+
+void Affine(const int32_t raw[], float out[], uint32_t len, float scale,
+            float offset) {
+  switch (GetLevel()) {
+#if SIMD_X86
+  case LEVEL_AVX2:
+    return AffineAvx2(raw, out, len, scale, offset);
+  case LEVEL_SSE2:
+    return AffineSse2(raw, out, len, scale, offset);
+#endif
+  default:
+    return AffineScalar(raw, out, len, scale, offset);
+  }
+}
+
+void Pid(const Pid_arrays &arrays, uint32_t len, float dt) {
+  switch (GetLevel()) {
+#if SIMD_X86
+  case LEVEL_AVX2:
+    return PidAvx2(arrays, len, dt);
+  case LEVEL_SSE2:
+    return PidSse2(arrays, len, dt);
+#endif
+  default:
+    return PidScalar(arrays, 0, len, dt);
+  }
+}
+
+void AlphaBeta(const Alpha_beta_arrays &arrays, uint32_t len) {
+  switch (GetLevel()) {
+#if SIMD_X86
+  case LEVEL_AVX2:
+    return AlphaBetaAvx2(arrays, len);
+  case LEVEL_SSE2:
+    return AlphaBetaSse2(arrays, len);
+#endif
+  default:
+    return AlphaBetaScalar(arrays, 0, len);
+  }
+}
+
+void Extrapolate(const float position[], const float speed[],
+                 const float lead[], float out[], uint32_t len) {
+  switch (GetLevel()) {
+#if SIMD_X86
+  case LEVEL_AVX2:
+    return ExtrapolateAvx2(position, speed, lead, out, len);
+  case LEVEL_SSE2:
+    return ExtrapolateSse2(position, speed, lead, out, len);
+#endif
+  default:
+    return ExtrapolateScalar(position, speed, lead, out, len);
+  }
+}
+
+} // namespace Simd
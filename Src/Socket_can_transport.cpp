@@ -0,0 +1,369 @@
+/**
+ * @file Socket_can_transport.cpp
+ * @brief 实现 Socket_can_transport.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Socket_can_transport.hpp"
+#include "Logger.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <linux/can.h>
+#include <linux/can/error.h>
+#include <linux/can/raw.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#include <net/if.h>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace EcanVci {
+
+static_assert(Can_backend<Socket_can_transport>);
+
+namespace {
+
+// 每次系统调用处理的最大帧数，收发缓冲放在栈上
+constexpr ULONG BATCH = 64;
+constexpr size_t CONTROL_SIZE = CMSG_SPACE(sizeof(scm_timestamping)) +
+                                CMSG_SPACE(sizeof(uint32_t));
+constexpr canid_t EXACT_MASK = CAN_SFF_MASK | CAN_EFF_FLAG | CAN_RTR_FLAG;
+constexpr uint16_t MANAGEMENT_ID = 0x7FF;
+
+can_frame ToFrame(const CAN_OBJ &msg) {
+  can_frame frame = {};
+  frame.can_id = msg.ExternFlag ? (msg.ID & CAN_EFF_MASK) | CAN_EFF_FLAG
+                                : msg.ID & CAN_SFF_MASK;
+  if (msg.RemoteFlag) {
+    frame.can_id |= CAN_RTR_FLAG;
+  }
+  frame.can_dlc = std::min<BYTE>(msg.DataLen, CAN_MAX_DLEN);
+  memcpy(frame.data, msg.Data, frame.can_dlc);
+  return frame;
+}
+
+void ToObject(const can_frame &frame, CAN_OBJ &msg) {
+  msg = {};
+  msg.ExternFlag = (frame.can_id & CAN_EFF_FLAG) != 0;
+  msg.RemoteFlag = (frame.can_id & CAN_RTR_FLAG) != 0;
+  msg.ID = frame.can_id & (msg.ExternFlag ? CAN_EFF_MASK : CAN_SFF_MASK);
+  msg.DataLen = std::min<BYTE>(frame.can_dlc, CAN_MAX_DLEN);
+  memcpy(msg.Data, frame.data, msg.DataLen);
+}
+
+/**
+ * @brief 把错误帧换算为驱动的错误码
+ */
+UINT ErrorCode(const can_frame &frame) {
+  UINT code = 0;
+  if (frame.can_id & CAN_ERR_CRTL) {
+    if (frame.data[1] & (CAN_ERR_CRTL_RX_OVERFLOW | CAN_ERR_CRTL_TX_OVERFLOW)) {
+      code |= ERR_CAN_OVERFLOW;
+    }
+    if (frame.data[1] & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING)) {
+      code |= ERR_CAN_ERRALARM;
+    }
+    if (frame.data[1] & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE)) {
+      code |= ERR_CAN_PASSIVE;
+    }
+  }
+  if (frame.can_id & CAN_ERR_LOSTARB) {
+    code |= ERR_CAN_LOSE;
+  }
+  if (frame.can_id & (CAN_ERR_PROT | CAN_ERR_BUSERROR | CAN_ERR_BUSOFF)) {
+    code |= ERR_CAN_BUSERR;
+  }
+  return code;
+}
+
+/**
+ * @brief CLOCK_MONOTONIC 与 CLOCK_REALTIME 之差 us，用于换算内核的软件时间戳
+ */
+int64_t MonotonicOffset() {
+  timespec monotonic, realtime;
+  clock_gettime(CLOCK_MONOTONIC, &monotonic);
+  clock_gettime(CLOCK_REALTIME, &realtime);
+  return (static_cast<int64_t>(monotonic.tv_sec) - realtime.tv_sec) * 1000000 +
+         (static_cast<int64_t>(monotonic.tv_nsec) - realtime.tv_nsec) / 1000;
+}
+
+} // namespace
+
+Socket_can_transport::Socket_can_transport(const std::string &interface,
+                                           const std::vector<uint16_t> &ids,
+                                           uint32_t bitrate)
+    : interface(interface), bitrate(bitrate), capture(nullptr),
+      last_timestamp(0), pending_errors(0), reported_dropped(0) {
+  socket_fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+  if (socket_fd < 0) {
+    LOG_ERROR("Create CAN socket failed, errno {}", errno);
+    throw std::runtime_error("Create CAN socket failed");
+  }
+
+  ifindex = static_cast<int>(if_nametoindex(interface.c_str()));
+  if (ifindex == 0) {
+    close(socket_fd);
+    LOG_ERROR("CAN interface {} not found, errno {}", interface.c_str(), errno);
+    throw std::runtime_error("CAN interface not found");
+  }
+
+  // 错误帧由 Receive 换算为错误码，不交给调用方
+  can_err_mask_t error_mask = CAN_ERR_CRTL | CAN_ERR_LOSTARB | CAN_ERR_PROT |
+                              CAN_ERR_BUSERROR | CAN_ERR_BUSOFF;
+  if (setsockopt(socket_fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &error_mask,
+                 sizeof(error_mask)) != 0) {
+    LOG_WARN("CAN {} error frames unavailable, errno {}", interface.c_str(),
+             errno);
+  }
+  int enable = 1;
+  if (setsockopt(socket_fd, SOL_SOCKET, SO_RXQ_OVFL, &enable,
+                 sizeof(enable)) != 0) {
+    LOG_WARN("CAN {} drop counter unavailable, errno {}", interface.c_str(),
+             errno);
+  }
+  int timestamping = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+                     SOF_TIMESTAMPING_RX_HARDWARE |
+                     SOF_TIMESTAMPING_RAW_HARDWARE;
+  if (setsockopt(socket_fd, SOL_SOCKET, SO_TIMESTAMPING, &timestamping,
+                 sizeof(timestamping)) != 0) {
+    LOG_WARN("CAN {} timestamping unavailable, errno {}", interface.c_str(),
+             errno);
+  }
+
+  sockaddr_can address = {};
+  address.can_family = AF_CAN;
+  address.can_ifindex = ifindex;
+  if (SetFilter(ids) != STATUS_OK ||
+      bind(socket_fd, reinterpret_cast<sockaddr *>(&address),
+           sizeof(address)) != 0) {
+    close(socket_fd);
+    LOG_ERROR("Bind CAN {} failed, errno {}", interface.c_str(), errno);
+    throw std::runtime_error("Bind CAN socket failed");
+  }
+  LOG_INFO("CAN {} opened", interface.c_str());
+}
+
+Socket_can_transport::~Socket_can_transport() { close(socket_fd); }
+
+DWORD Socket_can_transport::SetFilter(const std::vector<uint16_t> &ids) const {
+  std::vector<can_filter> filters;
+  if (ids.empty()) {
+    filters.push_back({0, 0});
+  } else {
+    // 0x7FF 反馈帧内的电机 ID 在数据段，内核无法按其过滤，全部接收
+    filters.reserve(ids.size() + 1);
+    for (uint16_t id : ids) {
+      filters.push_back({id, EXACT_MASK});
+    }
+    filters.push_back({MANAGEMENT_ID, EXACT_MASK});
+  }
+  if (setsockopt(socket_fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters.data(),
+                 static_cast<socklen_t>(filters.size() * sizeof(can_filter))) !=
+      0) {
+    LOG_ERROR("Set CAN {} filter failed, errno {}", interface.c_str(), errno);
+    return STATUS_ERR;
+  }
+  return STATUS_OK;
+}
+
+void Socket_can_transport::AttachCapture(const Can_capture *capture) {
+  this->capture = capture;
+}
+
+DWORD Socket_can_transport::Transmit(CAN_OBJ msgs[], ULONG len) const {
+  can_frame frames[BATCH];
+  iovec iov[BATCH];
+  mmsghdr headers[BATCH];
+
+  DWORD sent = 0;
+  while (sent < len) {
+    ULONG count = std::min(BATCH, len - sent);
+    for (ULONG i = 0; i < count; i++) {
+      frames[i] = ToFrame(msgs[sent + i]);
+      iov[i] = {&frames[i], sizeof(can_frame)};
+      headers[i] = {};
+      headers[i].msg_hdr.msg_iov = &iov[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+    }
+    int result;
+    {
+      MOTOR_PROFILE_SCOPE(PHASE_TRANSMIT);
+      result = sendmmsg(socket_fd, headers, count, MSG_DONTWAIT);
+    }
+    if (result <= 0) {
+      // 发送队列满时返回已发送的数量，由调用方决定是否重发
+      LOG_EVERY(Log::ERROR, 1000, "CAN {} sendmmsg failed, errno {}",
+                interface.c_str(), errno);
+      break;
+    }
+    sent += static_cast<DWORD>(result);
+    if (static_cast<ULONG>(result) < count) {
+      break;
+    }
+  }
+  if (capture && sent > 0) {
+    capture->Record(0, 0, msgs, sent);
+  }
+  return sent;
+}
+
+DWORD Socket_can_transport::Receive(CAN_OBJ msgs[], ULONG len,
+                                    INT wait_time) const {
+  can_frame frames[BATCH];
+  iovec iov[BATCH];
+  mmsghdr headers[BATCH];
+  alignas(cmsghdr) char control[BATCH][CONTROL_SIZE];
+
+  DWORD received = 0;
+  bool waited = false;
+  while (received < len) {
+    ULONG count = std::min(BATCH, len - received);
+    for (ULONG i = 0; i < count; i++) {
+      iov[i] = {&frames[i], sizeof(can_frame)};
+      headers[i] = {};
+      headers[i].msg_hdr.msg_iov = &iov[i];
+      headers[i].msg_hdr.msg_iovlen = 1;
+      headers[i].msg_hdr.msg_control = control[i];
+      headers[i].msg_hdr.msg_controllen = CONTROL_SIZE;
+    }
+    int result;
+    {
+      MOTOR_PROFILE_SCOPE(PHASE_RECEIVE);
+      result = recvmmsg(socket_fd, headers, count, MSG_DONTWAIT, nullptr);
+    }
+    if (result <= 0) {
+      // 一帧都没有时才等待，之后只取已到达的帧
+      if (received > 0 || waited || wait_time <= 0) {
+        break;
+      }
+      pollfd fd = {socket_fd, POLLIN, 0};
+      if (poll(&fd, 1, wait_time) <= 0) {
+        break;
+      }
+      waited = true;
+      continue;
+    }
+
+    // 每批取一次偏移，批内的帧在同一时刻被取走
+    int64_t offset = MonotonicOffset();
+    for (int i = 0; i < result; i++) {
+      const can_frame &frame = frames[i];
+      uint64_t timestamp = 0;
+      for (cmsghdr *cmsg = CMSG_FIRSTHDR(&headers[i].msg_hdr); cmsg;
+           cmsg = CMSG_NXTHDR(&headers[i].msg_hdr, cmsg)) {
+        if (cmsg->cmsg_level != SOL_SOCKET) {
+          continue;
+        }
+        if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+          // ts[2] 为原始硬件时间戳（控制器时钟，单调）；ts[0] 为软件时间戳，
+          // 取自 CLOCK_REALTIME，换算到 CLOCK_MONOTONIC，不随系统校时跳变
+          scm_timestamping stamps;
+          memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+          bool hardware = stamps.ts[2].tv_sec || stamps.ts[2].tv_nsec;
+          const timespec &ts = hardware ? stamps.ts[2] : stamps.ts[0];
+          int64_t stamp = static_cast<int64_t>(ts.tv_sec) * 1000000 +
+                          ts.tv_nsec / 1000 + (hardware ? 0 : offset);
+          timestamp = stamp > 0 ? static_cast<uint64_t>(stamp) : 0;
+        } else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+          uint32_t dropped;
+          memcpy(&dropped, CMSG_DATA(cmsg), sizeof(dropped));
+          if (dropped != reported_dropped) {
+            pending_errors.fetch_or(ERR_BUFFEROVERFLOW,
+                                    std::memory_order_relaxed);
+            reported_dropped = dropped;
+          }
+        }
+      }
+
+      if (frame.can_id & CAN_ERR_FLAG) {
+        pending_errors.fetch_or(ErrorCode(frame), std::memory_order_relaxed);
+        continue;
+      }
+      CAN_OBJ &msg = msgs[received++];
+      ToObject(frame, msg);
+      if (timestamp) {
+        msg.TimeStamp = static_cast<UINT>(timestamp);
+        msg.TimeFlag = 1;
+        last_timestamp.store(timestamp, std::memory_order_relaxed);
+      }
+    }
+    if (static_cast<ULONG>(result) < count) {
+      break;
+    }
+  }
+  if (capture && received > 0) {
+    capture->Record(CAPTURE_RX, 0, msgs, received);
+  }
+  return received;
+}
+
+uint64_t Socket_can_transport::Timestamp(const CAN_OBJ &msg) const {
+  if (!msg.TimeFlag) {
+    return 0;
+  }
+  // 以最近一次接收的时间补齐高位，帧在 2^31 us 内被处理即可还原
+  constexpr uint64_t WRAP = 1ULL << 32;
+  uint64_t last = last_timestamp.load(std::memory_order_relaxed);
+  uint64_t timestamp = (last & ~(WRAP - 1)) | msg.TimeStamp;
+  if (timestamp > last + WRAP / 2 && timestamp >= WRAP) {
+    timestamp -= WRAP;
+  }
+  return timestamp;
+}
+
+DWORD Socket_can_transport::ReadError(ERR_INFO &error) const {
+  error = {};
+  error.ErrCode = pending_errors.exchange(0, std::memory_order_relaxed);
+  return STATUS_OK;
+}
+
+DWORD Socket_can_transport::Transmit(UINT destination, BYTE data[],
+                                     ULONG len) const {
+  if (len > 8) {
+    LOG_ERROR("Data length should be less than or equal to 8");
+    throw std::runtime_error("Data length should be less than or equal to 8");
+  }
+  CAN_OBJ msg = {};
+  msg.ID = destination;
+  msg.DataLen = static_cast<BYTE>(len);
+  memcpy(msg.Data, data, len);
+  if (Transmit(&msg, 1) != 1) {
+    LOG_ERROR("Transmit failed");
+    throw std::runtime_error("Transmit failed");
+  }
+  return 1;
+}
+
+DWORD Socket_can_transport::ReceiveOnce(UINT &source, BYTE data[], ULONG &len,
+                                        ULONG wait_time) const {
+  CAN_OBJ msg;
+  if (Receive(&msg, 1, static_cast<INT>(wait_time)) == 0) {
+    return STATUS_ERR;
+  }
+  source = msg.ID;
+  len = msg.DataLen;
+  memcpy(data, msg.Data, len);
+  return 1;
+}
+
+DWORD Socket_can_transport::ReceiveLast(UINT &source, BYTE data[], ULONG &len,
+                                        ULONG wait_time) const {
+  CAN_OBJ msg[100];
+  auto result = Receive(msg, 100, static_cast<INT>(wait_time));
+  if (result == 0) {
+    return STATUS_ERR;
+  }
+  source = msg[result - 1].ID;
+  len = msg[result - 1].DataLen;
+  memcpy(data, msg[result - 1].Data, len);
+  return result;
+}
+
+} // namespace EcanVci
@@ -0,0 +1,149 @@
+/**
+ * @file Sync_commit.cpp
+ * @brief 实现 Sync_commit.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Sync_commit.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+
+namespace Motor {
+
+Sync_commit::Sync_commit(bool parallel, std::chrono::microseconds arm_time)
+    : parallel(parallel), arm_time(arm_time), epoch(0), pending(0),
+      running(true), commits(0), max_skew(0), total_skew(0) {}
+
+Sync_commit::~Sync_commit() {
+  running.store(false, std::memory_order_relaxed);
+  epoch.fetch_add(1, std::memory_order_release);
+  epoch.notify_all();
+  for (auto &device : devices) {
+    if (device->worker.joinable()) {
+      device->worker.join();
+    }
+  }
+}
+
+uint32_t Sync_commit::AddToDevice(EcanVci::Can_backend_handle backend,
+                                  uint32_t capacity, uint32_t device) {
+  channels.push_back(std::make_unique<Channel>(backend, capacity));
+  Channel &channel = *channels.back();
+  if (device != DEVICE_NONE) {
+    for (auto &existing : devices) {
+      if (existing->key == device) {
+        // 工作线程只在 Commit 唤醒后读取通道列表
+        existing->channels.push_back(&channel);
+        return Size() - 1;
+      }
+    }
+  }
+  devices.push_back(std::make_unique<Device>());
+  Device &added = *devices.back();
+  added.key = device;
+  added.channels.push_back(&channel);
+  if (parallel) {
+    // 在此读取代号，线程晚于下一次 Commit 启动时也不会漏掉
+    added.worker = std::thread(&Sync_commit::Worker, this, std::ref(added),
+                               epoch.load(std::memory_order_relaxed));
+  }
+  return Size() - 1;
+}
+
+void Sync_commit::Clear() {
+  for (auto &channel : channels) {
+    channel->batch.Clear();
+  }
+}
+
+void Sync_commit::Send(Device &device) {
+  for (Channel *channel : device.channels) {
+    channel->sent = 0;
+    if (channel->batch.Size() == 0) {
+      continue;
+    }
+    channel->begin = std::chrono::steady_clock::now();
+    channel->sent = channel->batch.Transmit(channel->backend);
+    channel->end = std::chrono::steady_clock::now();
+  }
+}
+
+void Sync_commit::Worker(Device &device, uint32_t seen) {
+  while (true) {
+    epoch.wait(seen, std::memory_order_acquire);
+    seen = epoch.load(std::memory_order_acquire);
+    if (!running.load(std::memory_order_relaxed)) {
+      return;
+    }
+    // 已提前唤醒，自旋到放行时刻，各设备在同一时刻进入驱动
+    while (std::chrono::steady_clock::now() < release_at) {
+      std::this_thread::yield();
+    }
+    Send(device);
+    if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      pending.notify_one();
+    }
+  }
+}
+
+Commit_report Sync_commit::Commit() {
+  Commit_report report = {};
+  auto start = std::chrono::steady_clock::now();
+  if (std::all_of(channels.begin(), channels.end(),
+                  [](const auto &channel) {
+                    return channel->batch.Size() == 0;
+                  })) {
+    return report;
+  }
+
+  if (parallel) {
+    pending.store(static_cast<uint32_t>(devices.size()),
+                  std::memory_order_relaxed);
+    release_at = start + arm_time;
+    epoch.fetch_add(1, std::memory_order_release);
+    epoch.notify_all();
+    uint32_t remain;
+    while ((remain = pending.load(std::memory_order_acquire)) != 0) {
+      pending.wait(remain, std::memory_order_acquire);
+    }
+  } else {
+    release_at = start;
+    for (auto &device : devices) {
+      Send(*device);
+    }
+  }
+
+  auto first_begin = std::chrono::steady_clock::time_point::max();
+  auto last_begin = std::chrono::steady_clock::time_point::min();
+  auto first_end = first_begin, last_end = last_begin;
+  for (const auto &channel : channels) {
+    if (channel->batch.Size() == 0) {
+      continue;
+    }
+    first_begin = std::min(first_begin, channel->begin);
+    last_begin = std::max(last_begin, channel->begin);
+    first_end = std::min(first_end, channel->end);
+    last_end = std::max(last_end, channel->end);
+    report.frames += channel->sent;
+    if (channel->sent != channel->batch.Size()) {
+      report.failed++;
+    }
+  }
+  report.release_skew = last_begin - first_begin;
+  report.completion_skew = last_end - first_end;
+  report.release_lag = std::max(last_begin - release_at,
+                                std::chrono::steady_clock::duration::zero());
+  report.duration = last_end - start;
+  commits++;
+  max_skew = std::max(max_skew, report.release_skew);
+  total_skew += report.release_skew;
+  if (report.failed) {
+    LOG_EVERY(Log::ERROR, 1000, "Synchronized commit: {} channels incomplete",
+              report.failed);
+  }
+  return report;
+}
+
+} // namespace Motor
@@ -0,0 +1,150 @@
+/**
+ * @file Telemetry.cpp
+ * @brief 实现 Telemetry.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Telemetry.hpp"
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Motor {
+
+namespace {
+
+constexpr uint32_t TELEMETRY_MAGIC = 0x4D4C4554; // "TELM"
+constexpr uint16_t TELEMETRY_VERSION = 1;
+
+uint64_t Now() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000000ULL + now.tv_nsec;
+}
+
+} // namespace
+
+Telemetry_publisher::Telemetry_publisher(const std::string &name,
+                                         uint32_t slot_count)
+    : name(name) {
+  mapped_size = sizeof(Telemetry_header) + slot_count * sizeof(Telemetry_slot);
+
+  // 不复用同名区域：缩小仍被读端映射的区域会使其访问越界（SIGBUS）。
+  // 删除后独占创建，旧读端继续映射旧区域直到重新连接
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Open telemetry shared memory failed");
+  }
+  if (ftruncate(fd, mapped_size) != 0) {
+    close(fd);
+    throw std::runtime_error("Resize telemetry shared memory failed");
+  }
+  void *base =
+      mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    throw std::runtime_error("Map telemetry shared memory failed");
+  }
+  header = static_cast<Telemetry_header *>(base);
+  slots = reinterpret_cast<Telemetry_slot *>(header + 1);
+
+  // 新区域全为 0，魔数最后写入，读端在初始化期间连接会失败
+  header->version = TELEMETRY_VERSION;
+  header->slot_size = sizeof(Telemetry_slot);
+  header->slot_count = slot_count;
+  header->history_size = TELEMETRY_HISTORY;
+  header->generation.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  header->magic = TELEMETRY_MAGIC;
+}
+
+Telemetry_publisher::~Telemetry_publisher() {
+  munmap(header, mapped_size);
+  shm_unlink(name.c_str());
+}
+
+void Telemetry_publisher::Publish(uint32_t index, uint16_t motor_id,
+                                  const Motor_control::Motor_info &info) const {
+  if (index >= header->slot_count) {
+    return;
+  }
+  Telemetry_slot &slot = slots[index];
+  BeginWrite(slot);
+  slot.motor_id = motor_id;
+  slot.update_timestamp = Now();
+  slot.info = info;
+  EndWrite(slot);
+}
+
+void Telemetry_publisher::RecordCommand(uint32_t index,
+                                        const CAN_OBJ &msg) const {
+  if (index >= header->slot_count) {
+    return;
+  }
+  Telemetry_slot &slot = slots[index];
+  BeginWrite(slot);
+  Telemetry_command &command =
+      slot.history[slot.command_count % TELEMETRY_HISTORY];
+  command.timestamp = Now();
+  command.id = msg.ID;
+  command.data_len = msg.DataLen;
+  memcpy(command.data, msg.Data, 8);
+  slot.command_count++;
+  EndWrite(slot);
+}
+
+Telemetry_reader::Telemetry_reader(const std::string &name) {
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    throw std::runtime_error("Open telemetry shared memory failed");
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < sizeof(Telemetry_header)) {
+    close(fd);
+    throw std::runtime_error("Telemetry shared memory too small");
+  }
+  mapped_size = st.st_size;
+  void *base = mmap(nullptr, mapped_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) {
+    throw std::runtime_error("Map telemetry shared memory failed");
+  }
+  header = static_cast<const Telemetry_header *>(base);
+  slots = reinterpret_cast<const Telemetry_slot *>(header + 1);
+
+  if (header->magic != TELEMETRY_MAGIC ||
+      header->version != TELEMETRY_VERSION ||
+      header->slot_size != sizeof(Telemetry_slot) ||
+      sizeof(Telemetry_header) + header->slot_count * sizeof(Telemetry_slot) >
+          mapped_size) {
+    munmap(base, mapped_size);
+    throw std::runtime_error("Invalid telemetry shared memory");
+  }
+}
+
+Telemetry_reader::~Telemetry_reader() {
+  munmap(const_cast<Telemetry_header *>(header), mapped_size);
+}
+
+bool Telemetry_reader::Read(uint32_t index, uint16_t &motor_id,
+                            Motor_control::Motor_info &info) const {
+  for (uint32_t i = 0; i < READ_RETRIES; i++) {
+    uint32_t sequence = BeginRead(index);
+    motor_id = slots[index].motor_id;
+    info = slots[index].info;
+    if (EndRead(index, sequence)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace Motor
@@ -0,0 +1,134 @@
+/**
+ * @file Trajectory.cpp
+ * @brief 实现 Trajectory.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Trajectory.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Motor {
+
+Motion_profile::Motion_profile()
+    : distance(0), speed_limit(0), acceleration_limit(0), jerk(0),
+      acceleration_time(0), jerk_time(0), cruise_time(0) {}
+
+Motion_profile Motion_profile::Plan(Profile_type type, double distance,
+                                    const Profile_limits &limits) {
+  Motion_profile profile;
+  double d = std::fabs(distance);
+  double v = limits.speed, a = limits.acceleration, j = limits.jerk;
+  if (d == 0 || v <= 0 || a <= 0) {
+    return profile;
+  }
+  bool s_curve = type == PROFILE_S_CURVE && j > 0;
+
+  // 双 S 曲线，见 Biagiotti & Melchiorri 3.4；梯形时加加速度段为 0
+  double tj, ta;
+  if (!s_curve) {
+    tj = 0;
+    ta = v / a;
+  } else if (v * j >= a * a) {
+    tj = a / j;
+    ta = tj + v / a;
+  } else {
+    tj = std::sqrt(v / j);
+    ta = 2 * tj;
+  }
+  double tv = d / v - ta;
+  if (tv < 0) {
+    // 达不到最大速度，没有匀速段
+    tv = 0;
+    if (!s_curve) {
+      ta = std::sqrt(d / a);
+    } else {
+      tj = a / j;
+      ta = tj / 2 + std::sqrt(tj * tj / 4 + d / a);
+      if (ta < 2 * tj) {
+        // 也达不到最大加速度
+        tj = std::cbrt(d / (2 * j));
+        ta = 2 * tj;
+      }
+    }
+  }
+
+  profile.distance = distance;
+  profile.jerk = s_curve ? j : 0;
+  profile.jerk_time = tj;
+  profile.acceleration_time = ta;
+  profile.cruise_time = tv;
+  profile.acceleration_limit = s_curve ? j * tj : a;
+  profile.speed_limit = profile.acceleration_limit * (ta - tj);
+  return profile;
+}
+
+void Motion_profile::Sample(double t, double &position, double &speed) const {
+  double ta = acceleration_time, tj = jerk_time;
+  double v = speed_limit, a = acceleration_limit;
+  double total = Duration();
+  double sign = distance < 0 ? -1 : 1;
+
+  // 减速段与加速段对称，按到终点的剩余时间求加速段的值
+  auto accelerate = [&](double t, double &s, double &ds) {
+    if (t < tj) {
+      s = jerk * t * t * t / 6;
+      ds = jerk * t * t / 2;
+    } else if (t < ta - tj) {
+      s = a / 6 * (3 * t * t - 3 * tj * t + tj * tj);
+      ds = a * (t - tj / 2);
+    } else {
+      double u = ta - t;
+      s = v * ta / 2 - v * u + jerk * u * u * u / 6;
+      ds = v - jerk * u * u / 2;
+    }
+  };
+
+  double s, ds;
+  if (total <= 0 || t >= total) {
+    s = std::fabs(distance);
+    ds = 0;
+  } else if (t <= 0) {
+    s = ds = 0;
+  } else if (t < ta) {
+    accelerate(t, s, ds);
+  } else if (t < ta + cruise_time) {
+    s = v * ta / 2 + v * (t - ta);
+    ds = v;
+  } else {
+    accelerate(total - t, s, ds);
+    s = std::fabs(distance) - s;
+  }
+  position = sign * s;
+  speed = sign * ds;
+}
+
+Trajectory::Trajectory(uint32_t axes) : axes(axes) {
+  if (axes == 0) {
+    throw std::runtime_error("Trajectory needs at least one axis");
+  }
+}
+
+void Trajectory::AddWaypoint(const float target[],
+                             const Profile_limits &limits, Profile_type type) {
+  if (limits.speed <= 0 || limits.acceleration <= 0) {
+    throw std::runtime_error("Profile limits must be positive");
+  }
+  uint32_t row = static_cast<uint32_t>(values.size() / axes);
+  values.insert(values.end(), target, target + axes);
+  segments.push_back({false, type, limits, row, 1});
+}
+
+void Trajectory::AddSamples(const float positions[], uint32_t ticks) {
+  if (ticks == 0) {
+    return;
+  }
+  uint32_t row = static_cast<uint32_t>(values.size() / axes);
+  values.insert(values.end(), positions, positions + ticks * axes);
+  segments.push_back({true, PROFILE_TRAPEZOID, {}, row, ticks});
+}
+
+} // namespace Motor
@@ -0,0 +1,254 @@
+/**
+ * @file Trajectory_executor.cpp
+ * @brief 实现 Trajectory_executor.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Trajectory_executor.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+
+namespace Motor {
+
+Trajectory_executor::Trajectory_executor(float period, uint32_t lead)
+    : period(period), lead(std::max<uint32_t>(lead, 1)), mask(0), produced(0),
+      consumed(0), generation(0), cut(0), underruns(0), head(0), segment(0),
+      tick(0), distance(0), blend_from(0), blend_end(0), blend_ticks(0),
+      blended(0), stale_begin(0), stale_end(0) {
+  if (period <= 0) {
+    throw std::runtime_error("Trajectory period must be positive");
+  }
+}
+
+uint32_t Trajectory_executor::Add(const Motor_core &motor,
+                                  const Trajectory_axis &config) {
+  if (!slots.empty()) {
+    throw std::runtime_error("Axes must be added before loading trajectories");
+  }
+  axes.push_back({&motor, config});
+  position.push_back(motor.motor_info.position);
+  speed.push_back(0.0f);
+  start.push_back(0.0f);
+  delta.push_back(0.0f);
+  return Size() - 1;
+}
+
+void Trajectory_executor::Prepare() {
+  if (!slots.empty()) {
+    return;
+  }
+  // 抢占后旧帧与新帧同时在环中，容量取 2 * lead
+  uint64_t capacity = std::bit_ceil(2 * static_cast<uint64_t>(lead));
+  slots.reserve(capacity);
+  for (uint64_t i = 0; i < capacity; i++) {
+    slots.emplace_back(Size());
+  }
+  mask = capacity - 1;
+}
+
+void Trajectory_executor::Load(const Trajectory &trajectory) {
+  if (trajectory.Axes() != Size()) {
+    throw std::runtime_error("Trajectory axes mismatch");
+  }
+  Prepare();
+  queue.push_back(trajectory);
+}
+
+bool Trajectory_executor::Advance() {
+  while (!queue.empty()) {
+    const Trajectory &trajectory = queue.front();
+    if (segment >= trajectory.Segments().size()) {
+      queue.pop_front();
+      segment = 0;
+      tick = 0;
+      continue;
+    }
+    const Trajectory::Segment &current = trajectory.Segments()[segment];
+
+    if (current.sampled) {
+      if (tick < current.rows) {
+        const float *row = trajectory.Row(current.first_row +
+                                          static_cast<uint32_t>(tick));
+        for (uint32_t i = 0; i < Size(); i++) {
+          speed[i] = (row[i] - position[i]) / period;
+          position[i] = row[i];
+        }
+        tick++;
+        return true;
+      }
+    } else {
+      if (tick == 0) {
+        // 以位移最大的轴规划，其余轴按比例同步
+        const float *target = trajectory.Row(current.first_row);
+        distance = 0;
+        for (uint32_t i = 0; i < Size(); i++) {
+          start[i] = position[i];
+          delta[i] = target[i] - position[i];
+          distance = std::max<double>(distance, std::fabs(delta[i]));
+        }
+        profile = Motion_profile::Plan(current.type, distance, current.limits);
+      }
+      uint64_t ticks =
+          distance > 0
+              ? static_cast<uint64_t>(std::ceil(profile.Duration() / period))
+              : 0;
+      if (tick < ticks) {
+        double s, ds;
+        profile.Sample(static_cast<double>(tick + 1) * period, s, ds);
+        double ratio = s / distance, rate = ds / distance;
+        for (uint32_t i = 0; i < Size(); i++) {
+          position[i] = static_cast<float>(start[i] + delta[i] * ratio);
+          speed[i] = static_cast<float>(delta[i] * rate);
+        }
+        tick++;
+        return true;
+      }
+    }
+    segment++;
+    tick = 0;
+  }
+  return false;
+}
+
+void Trajectory_executor::Produce(uint32_t slot_generation) {
+  Slot &slot = slots[head & mask];
+  slot.position = position;
+  slot.speed = speed;
+
+  if (blended < blend_ticks && blend_from + blended < blend_end) {
+    // 旧帧仍在环中未被覆盖，按平滑权重过渡到新轨迹
+    const Slot &old = slots[(blend_from + blended) & mask];
+    float x = static_cast<float>(blended + 1) / (blend_ticks + 1);
+    float w = x * x * (3.0f - 2.0f * x);
+    for (uint32_t i = 0; i < Size(); i++) {
+      slot.position[i] = old.position[i] + (position[i] - old.position[i]) * w;
+      slot.speed[i] = old.speed[i] + (speed[i] - old.speed[i]) * w;
+    }
+    blended++;
+  }
+
+  // 提前编码的帧不写遥测，Tick 发出时由 Frame_batch 记录
+  slot.batch.Clear();
+  for (uint32_t i = 0; i < Size(); i++) {
+    const Axis &axis = axes[i];
+    const Trajectory_axis &config = axis.config;
+    if (config.command == COMMAND_POSITION) {
+      axis.motor->StagePosition(slot.batch, slot.position[i],
+                                config.speed_limit, config.current_limit,
+                                config.ack_status);
+    } else {
+      axis.motor->StageHybrid(slot.batch, config.kp, config.kd,
+                              slot.position[i], slot.speed[i], 0.0f);
+    }
+  }
+  slot.sequence = head;
+  slot.generation = slot_generation;
+  head++;
+}
+
+uint64_t Trajectory_executor::Ahead(uint64_t tail) const {
+  uint64_t stale =
+      tail < stale_end ? stale_end - std::max(tail, stale_begin) : 0;
+  return head - tail - stale;
+}
+
+uint32_t Trajectory_executor::Fill(uint32_t slot_generation) {
+  uint32_t count = 0;
+  while (true) {
+    uint64_t tail = consumed.load(std::memory_order_acquire);
+    if (head - tail >= slots.size() || Ahead(tail) >= lead || !Advance()) {
+      break;
+    }
+    Produce(slot_generation);
+    count++;
+  }
+  return count;
+}
+
+uint32_t Trajectory_executor::Fill() {
+  if (slots.empty()) {
+    return 0;
+  }
+  uint32_t count = Fill(generation.load(std::memory_order_relaxed));
+  produced.store(head, std::memory_order_release);
+  return count;
+}
+
+DWORD Trajectory_executor::Replace(const Trajectory &trajectory, uint32_t keep,
+                                   uint32_t blend_ticks) {
+  if (trajectory.Axes() != Size()) {
+    throw std::runtime_error("Trajectory axes mismatch");
+  }
+  Prepare();
+  uint64_t tail = consumed.load(std::memory_order_acquire);
+  if (tail < cut.load(std::memory_order_relaxed)) {
+    LOG_WARN("Trajectory preempted again before the last switch");
+    return STATUS_ERR;
+  }
+
+  // 切换点之前至少保留一个未发送的周期，其设定值不会被覆盖
+  uint64_t switch_at = std::min(tail + std::max<uint32_t>(keep, 1), head);
+  if (switch_at > 0) {
+    const Slot &last = slots[(switch_at - 1) & mask];
+    position = last.position;
+    speed = last.speed;
+  }
+
+  queue.clear();
+  queue.push_back(trajectory);
+  segment = 0;
+  tick = 0;
+  stale_begin = blend_from = switch_at;
+  stale_end = blend_end = head;
+  this->blend_ticks = blend_ticks;
+  blended = 0;
+
+  // 新代号的帧先写好再一并发布，实时线程不会在切换时欠载
+  uint32_t next = generation.load(std::memory_order_relaxed) + 1;
+  Fill(next);
+  cut.store(switch_at, std::memory_order_relaxed);
+  generation.store(next, std::memory_order_release);
+  produced.store(head, std::memory_order_release);
+  return STATUS_OK;
+}
+
+DWORD Trajectory_executor::Preempt(const Trajectory &trajectory,
+                                   uint32_t keep) {
+  return Replace(trajectory, keep, 0);
+}
+
+DWORD Trajectory_executor::Blend(const Trajectory &trajectory,
+                                 uint32_t blend_ticks, uint32_t keep) {
+  return Replace(trajectory, keep, blend_ticks);
+}
+
+DWORD Trajectory_executor::Tick(EcanVci::Can_backend_handle can_transport) {
+  // 先读 produced：看到新发布的帧时一定也看到新代号与切换点
+  uint64_t end = produced.load(std::memory_order_acquire);
+  uint32_t current = generation.load(std::memory_order_acquire);
+  uint64_t switch_at = cut.load(std::memory_order_relaxed);
+  uint64_t tail = consumed.load(std::memory_order_relaxed);
+
+  while (tail < end) {
+    Slot &slot = slots[tail & mask];
+    bool valid = slot.generation == current ||
+                 (slot.generation + 1 == current && slot.sequence < switch_at);
+    tail++;
+    if (valid) {
+      // Transmit 记录遥测后才交还槽位，之后生产者可能改写该批次
+      DWORD result = slot.batch.Transmit(can_transport);
+      consumed.store(tail, std::memory_order_release);
+      return result;
+    }
+  }
+  consumed.store(tail, std::memory_order_release);
+  underruns.fetch_add(1, std::memory_order_relaxed);
+  return 0;
+}
+
+} // namespace Motor
@@ -0,0 +1,151 @@
+/**
+ * @file Watchdog.cpp
+ * @brief 实现 Watchdog.hpp 中的函数
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ */
+
+#include "Watchdog.hpp"
+#include "Logger.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <time.h>
+
+namespace Motor {
+
+namespace {
+
+// 析构时最长等待一个该间隔
+constexpr uint64_t MAX_SLEEP = 100000000;
+
+void SleepUntil(uint64_t wake) {
+  timespec until;
+  until.tv_sec = static_cast<time_t>(wake / 1000000000ULL);
+  until.tv_nsec = static_cast<long>(wake % 1000000000ULL);
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr) ==
+         EINTR) {
+  }
+}
+
+} // namespace
+
+Watchdog::Watchdog(EcanVci::Can_backend_handle backend,
+                   std::chrono::nanoseconds deadline,
+                   std::chrono::nanoseconds safe_period)
+    : backend(backend), deadline(static_cast<uint64_t>(deadline.count())),
+      safe_period(static_cast<uint64_t>(
+          safe_period.count() > 0 ? safe_period.count() : deadline.count())),
+      heartbeat(0), tripped(false), running(true), overruns(0) {
+  if (deadline.count() <= 0) {
+    throw std::runtime_error("Watchdog deadline must be positive");
+  }
+  thread = std::thread(&Watchdog::Loop, this);
+}
+
+Watchdog::~Watchdog() {
+  running.store(false, std::memory_order_relaxed);
+  thread.join();
+}
+
+void Watchdog::Add(const Motor_core &motor, const Fault_reaction &safe) {
+  if (heartbeat.load(std::memory_order_acquire) != 0) {
+    throw std::runtime_error("Motors must be added before the first heartbeat");
+  }
+  if (safe.action == ACTION_NONE) {
+    throw std::runtime_error("Watchdog needs a safe setpoint");
+  }
+  if (safe.ack_status > ACK_TYPE_3) {
+    throw std::runtime_error("Unsupported ack type for safe setpoint");
+  }
+  CAN_OBJ msg;
+  if (safe.action == ACTION_BRAKE) {
+    motor.EncodeControlWithMode(msg, safe.brake_mode, safe.value,
+                                safe.ack_status);
+  } else {
+    motor.EncodeControlWithMode(msg, CURRENT_MODE, 0.0f, safe.ack_status);
+  }
+  safe_frames.push_back(msg);
+}
+
+void Watchdog::Heartbeat() {
+  heartbeat.store(Log::Now(), std::memory_order_release);
+}
+
+void Watchdog::Loop() {
+  while (running.load(std::memory_order_relaxed)) {
+    uint64_t now = Log::Now();
+    uint64_t last = heartbeat.load(std::memory_order_acquire);
+    uint64_t wake = last ? last + deadline : now + deadline;
+    SleepUntil(std::min(wake, now + MAX_SLEEP));
+
+    // 醒来后重新读取，控制环在睡眠期间更新过心跳即未超时
+    now = Log::Now();
+    last = heartbeat.load(std::memory_order_acquire);
+    if (last == 0 || now <= last + deadline) {
+      continue;
+    }
+    TakeOver(last);
+  }
+}
+
+uint32_t Watchdog::TakeOver(uint64_t last_heartbeat) {
+  uint64_t detected = Log::Now();
+  tripped.store(true, std::memory_order_release);
+  LOG_WARN("Control loop missed its deadline by {} us, watchdog taking over",
+           (detected - last_heartbeat - deadline) / 1000);
+  {
+    std::lock_guard<std::mutex> lock(history_mutex);
+    history.push_back({last_heartbeat, detected, 0, 0});
+    if (history.size() > HISTORY_SIZE) {
+      history.pop_front();
+    }
+    overruns++;
+  }
+
+  uint32_t batches = 0;
+  uint64_t next = detected;
+  ULONG size = static_cast<ULONG>(safe_frames.size());
+  while (running.load(std::memory_order_relaxed)) {
+    // 发送前重新检查，控制环恢复后不再发出安全设定值
+    if (heartbeat.load(std::memory_order_acquire) != last_heartbeat) {
+      break;
+    }
+    if (size > 0 && backend.Transmit(safe_frames.data(), size) != size) {
+      LOG_EVERY(Log::ERROR, 1000, "Watchdog failed to send safe setpoints");
+    }
+    batches++;
+
+    next += safe_period;
+    uint64_t now = Log::Now();
+    if (next < now) {
+      next = now;
+    }
+    SleepUntil(next);
+  }
+
+  uint64_t resumed = Log::Now();
+  {
+    std::lock_guard<std::mutex> lock(history_mutex);
+    // 只有本线程写入，末项即本次记录
+    history.back().resumed = resumed;
+    history.back().batches = batches;
+  }
+  tripped.store(false, std::memory_order_release);
+  LOG_WARN("Control loop resumed after {} us, {} safe batches sent",
+           (resumed - detected) / 1000, batches);
+  return batches;
+}
+
+uint64_t Watchdog::Overruns() const {
+  std::lock_guard<std::mutex> lock(history_mutex);
+  return overruns;
+}
+
+std::vector<Overrun_record> Watchdog::History() const {
+  std::lock_guard<std::mutex> lock(history_mutex);
+  return std::vector<Overrun_record>(history.begin(), history.end());
+}
+
+} // namespace Motor
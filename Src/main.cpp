@@ -9,47 +9,106 @@
  *
  */
 
+#include "Ack_policy.hpp"
+#include "Bus_budget.hpp"
+#include "Commissioning.hpp"
+#include "Logger.hpp"
 #include "Motor_control.hpp"
+#include "Telemetry.hpp"
 #include <chrono>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <thread>
 
 using namespace Motor;
 
-int main() {
+int main(int argc, char *argv[]) {
   try {
-    EcanVci::Can_transport can_transport;
+    // motor_test [--replay <file> [--fast]]
+    std::unique_ptr<EcanVci::Can_replay> replay;
+    bool fast = false;
+    for (int i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+        fast = i + 2 < argc && strcmp(argv[i + 2], "--fast") == 0;
+        replay = std::make_unique<EcanVci::Can_replay>(
+            argv[i + 1], fast ? EcanVci::REPLAY_AS_FAST_AS_POSSIBLE
+                              : EcanVci::REPLAY_ORIGINAL_SPEED);
+      }
+    }
+
+    std::unique_ptr<EcanVci::Can_transport> transport =
+        replay ? std::make_unique<EcanVci::Can_transport>(*replay)
+               : std::make_unique<EcanVci::Can_transport>();
+    EcanVci::Can_transport &can_transport = *transport;
+
+    // 常开抓包，回放时不覆盖原抓包
+    std::unique_ptr<EcanVci::Can_capture> capture;
+    if (!replay) {
+      capture = std::make_unique<EcanVci::Can_capture>("can_capture.bin");
+      can_transport.AttachCapture(capture.get());
+    }
 
     Motor_control motor(can_transport, 0x00, 0x01);
 
-    int times = 10;
-    while (times--) {
-      motor.ResetID();
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    // 每 10 个周期请求一次 ACK1，温度 1 s 内上升 4 个单位或报错时每周期请求
+    Ack_policy ack_policy(10, ACK_TYPE_1);
+    ack_policy.SetTemperatureThreshold(4, 1000);
+
+    // 控制环：1 个电机，1 kHz 电流命令
+    EcanVci::Bus_budget budget(can_transport);
+    budget.AddExchange("SetCurrent", CURRENT_FRAME_LENGTH, 0,
+                       1000 * (1 - ack_policy.NominalAckRatio()));
+    budget.AddExchange("SetCurrent+ACK1", CURRENT_FRAME_LENGTH,
+                       ReplyLength(ACK_TYPE_1),
+                       1000 * ack_policy.NominalAckRatio());
+    budget.Check(EcanVci::BUDGET_REJECT);
+
+    // 其他进程可通过 Telemetry_reader("/motor_telemetry") 读取电机状态
+    Telemetry_publisher telemetry("/motor_telemetry", 1);
+    motor.AttachTelemetry(&telemetry, 0);
+
+    // 上电调试：恢复出厂 ID 并以反馈帧确认，回放时没有电机应答，跳过
+    Async_executor executor(can_transport);
+    executor.Attach(motor);
+    if (!replay) {
+      Commissioning commissioning(executor);
+      commissioning.Add(motor, {.reset_id = true});
+      if (commissioning.Run() != 0) {
+        return 1;
+      }
     }
 
     uint32_t frames_count = 0;
-    while (true) {
+    while (!replay || !replay->Finished()) {
       // motor.SetSpeed(100, 0x0FFF, Message_return_status::ACK_TYPE_1);
-      motor.SetCurrent(160, Message_return_status::ACK_TYPE_1);
+      Message_return_status ack_status = ack_policy.Next();
+      motor.SetCurrent(160, ack_status);
       // motor.SetSpeed(100, 100, Message_return_status::ACK_TYPE_1);
       // motor.SetPosition(100, 100, 100, Message_return_status::ACK_TYPE_2);
       // motor.ControlWithMode(Control_mode::CURRENT_MODE, 100,
       // Message_return_status::ACK_TYPE_1);
 
-      if (motor.UpdateInfo()) {
-        std::cout << "Position: " << motor.motor_info.position
-                  << " Speed: " << motor.motor_info.speed
-                  << " Current: " << motor.motor_info.current << std::endl;
+      // NO_ACK 的周期电机不应答，不接收
+      if (ack_status != NO_ACK && motor.UpdateInfo()) {
+        ack_policy.Observe(motor.motor_info);
+        LOG_EVERY(Log::INFO, 100,
+                  "Position: {} rad Speed: {} rad/s Current: {} A",
+                  motor.motor_info.position, motor.motor_info.speed,
+                  motor.motor_info.current);
       }
 
       if (++frames_count % 100 == 0) {
-        std::cout << "Send frames count: " << frames_count << std::endl;
+        LOG_INFO("Send frames count: {}", frames_count);
       }
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      if (!fast) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
     }
   } catch (const std::exception &e) {
+    // 先输出此前的日志，再打印异常
+    Log::Flush();
     std::cerr << e.what() << '\n';
   }
   return 0;
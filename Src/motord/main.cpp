@@ -0,0 +1,315 @@
+/**
+ * @file main.cpp
+ * @author KalecKKK
+ * @brief motord：独占 CAN 适配器，通过共享内存环形队列向多个进程共享总线
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * motord [--socket <path>] [--channel <device_type>:<device_index>:<can_index>]...
+ *        [--capture <file>] [--replay <file>] [--idle-us <us>]
+ * 不指定 --channel 时使用 4:0:0；--replay 以抓包文件代替适配器作为通道 0，用于离线调试。
+ */
+
+#include "Can_capture.hpp"
+#include "Can_transport.hpp"
+#include "Logger.hpp"
+#include "Motord.hpp"
+#include <bitset>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace Motord;
+
+namespace {
+
+volatile std::sig_atomic_t running = 1;
+
+struct Channel {
+  uint32_t channel;
+  std::unique_ptr<EcanVci::Can_transport> transport;
+};
+
+struct Client {
+  int fd;
+  Channel *channel;
+  Motord_region *region;
+  bool filter_all;
+  std::bitset<2048> filter;
+};
+
+bool Accept(const Client &client, const CAN_OBJ &msg) {
+  if (client.filter_all) {
+    return true;
+  }
+  if (msg.ID == 0x7FF) {
+    if (msg.DataLen < 2) {
+      return true;
+    }
+    uint16_t id = msg.Data[0] << 8 | msg.Data[1];
+    // 查询ID、重置ID与查询失败的反馈不带具体电机ID，转发给所有客户端
+    if (id == 0xFFFF || id == 0x7F7F || id == 0x8080) {
+      return true;
+    }
+    return id < 2048 && client.filter[id];
+  }
+  return msg.ID < 2048 && client.filter[msg.ID];
+}
+
+void SetFilter(Client &client, const Motord_request &request) {
+  client.filter.reset();
+  client.filter_all = request.id_count == 0;
+  for (uint32_t i = 0; i < request.id_count && i < MAX_FILTER_IDS; i++) {
+    if (request.ids[i] < 2048) {
+      client.filter.set(request.ids[i]);
+    }
+  }
+}
+
+bool Reply(int fd, uint32_t status, int region_fd = -1) {
+  Motord_response response = {PROTOCOL_MAGIC, status};
+  iovec iov = {&response, sizeof(response)};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+  msghdr message = {};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+  if (region_fd >= 0) {
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    cmsghdr *cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &region_fd, sizeof(int));
+  }
+  return sendmsg(fd, &message, MSG_NOSIGNAL) == sizeof(response);
+}
+
+bool Attach(Client &client, std::vector<Channel> &channels,
+            const Motord_request &request) {
+  if (client.region) {
+    return Reply(client.fd, STATUS_ERR);
+  }
+  for (Channel &channel : channels) {
+    if (channel.channel != request.channel) {
+      continue;
+    }
+    int fd = memfd_create("motord", MFD_CLOEXEC);
+    if (fd < 0) {
+      break;
+    }
+    void *base = MAP_FAILED;
+    if (ftruncate(fd, sizeof(Motord_region)) == 0) {
+      base = mmap(nullptr, sizeof(Motord_region), PROT_READ | PROT_WRITE,
+                  MAP_SHARED, fd, 0);
+    }
+    if (base == MAP_FAILED) {
+      close(fd);
+      break;
+    }
+    client.region = new (base) Motord_region;
+    client.region->tx.Reset();
+    client.region->rx.Reset();
+    client.region->rx_dropped.store(0, std::memory_order_relaxed);
+    client.channel = &channel;
+    SetFilter(client, request);
+    bool result = Reply(client.fd, STATUS_OK, fd);
+    close(fd);
+    LOG_INFO("Client {} attached to channel {}", client.fd, channel.channel);
+    return result;
+  }
+  LOG_WARN("Client {} requested unknown channel {}", client.fd,
+           request.channel);
+  return Reply(client.fd, STATUS_ERR);
+}
+
+void Disconnect(Client &client) {
+  LOG_INFO("Client {} disconnected", client.fd);
+  if (client.region) {
+    munmap(client.region, sizeof(Motord_region));
+  }
+  close(client.fd);
+}
+
+/**
+ * @brief 处理控制面：新连接、控制请求与断开
+ */
+void Control(int listen_fd, std::vector<Client> &clients,
+             std::vector<Channel> &channels) {
+  std::vector<pollfd> fds;
+  fds.push_back({listen_fd, POLLIN, 0});
+  for (Client &client : clients) {
+    fds.push_back({client.fd, POLLIN, 0});
+  }
+  if (poll(fds.data(), fds.size(), 0) <= 0) {
+    return;
+  }
+
+  for (size_t i = fds.size() - 1; i > 0; i--) {
+    if (!fds[i].revents) {
+      continue;
+    }
+    Client &client = clients[i - 1];
+    Motord_request request;
+    ssize_t size = recv(client.fd, &request, sizeof(request), 0);
+    bool alive = size == sizeof(request) && request.magic == PROTOCOL_MAGIC;
+    if (alive && request.type == REQUEST_ATTACH) {
+      alive = Attach(client, channels, request);
+    } else if (alive && request.type == REQUEST_SET_FILTER) {
+      SetFilter(client, request);
+      alive = Reply(client.fd, STATUS_OK);
+    } else {
+      alive = false;
+    }
+    if (!alive) {
+      Disconnect(client);
+      clients.erase(clients.begin() + (i - 1));
+    }
+  }
+
+  if (fds[0].revents & POLLIN) {
+    int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd >= 0) {
+      clients.push_back({fd, nullptr, nullptr, true, {}});
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  const char *socket_path = DEFAULT_SOCKET;
+  const char *capture_path = nullptr;
+  std::unique_ptr<EcanVci::Can_replay> replay;
+  int idle_us = 20;
+  std::vector<Channel> channels;
+  std::vector<EcanVci::Channel_config> configs;
+
+  try {
+    for (int i = 1; i + 1 < argc; i += 2) {
+      if (strcmp(argv[i], "--socket") == 0) {
+        socket_path = argv[i + 1];
+      } else if (strcmp(argv[i], "--capture") == 0) {
+        capture_path = argv[i + 1];
+      } else if (strcmp(argv[i], "--replay") == 0) {
+        replay = std::make_unique<EcanVci::Can_replay>(argv[i + 1]);
+        channels.push_back(
+            {0, std::make_unique<EcanVci::Can_transport>(*replay)});
+      } else if (strcmp(argv[i], "--idle-us") == 0) {
+        idle_us = atoi(argv[i + 1]);
+      } else if (strcmp(argv[i], "--channel") == 0) {
+        unsigned type, index, can;
+        if (sscanf(argv[i + 1], "%u:%u:%u", &type, &index, &can) != 3 ||
+            can > 1) {
+          fprintf(stderr, "Invalid channel: %s\n", argv[i + 1]);
+          return 1;
+        }
+        configs.push_back({type, index, static_cast<EcanVci::CAN_ID>(can)});
+      }
+    }
+    if (channels.empty() && configs.empty()) {
+      configs.push_back({0x04, 0x00, EcanVci::CAN_1});
+    }
+    // 各适配器并行打开
+    auto transports = EcanVci::Can_transport::OpenAll(configs);
+    for (size_t i = 0; i < transports.size(); i++) {
+      channels.push_back(
+          {configs[i].device_index << 1 | configs[i].can_index,
+           std::move(transports[i])});
+    }
+
+    std::unique_ptr<EcanVci::Can_capture> capture;
+    if (capture_path) {
+      capture = std::make_unique<EcanVci::Can_capture>(capture_path);
+      for (Channel &channel : channels) {
+        channel.transport->AttachCapture(capture.get());
+      }
+    }
+
+    int listen_fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socket_path, sizeof(address.sun_path) - 1);
+    unlink(socket_path);
+    if (listen_fd < 0 ||
+        bind(listen_fd, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) != 0 ||
+        listen(listen_fd, 16) != 0) {
+      LOG_ERROR("Listen on {} failed", socket_path);
+      throw std::runtime_error("Listen failed");
+    }
+    LOG_INFO("motord listening on {}", socket_path);
+
+    std::signal(SIGINT, [](int) { running = 0; });
+    std::signal(SIGTERM, [](int) { running = 0; });
+
+    std::vector<Client> clients;
+    CAN_OBJ buffer[100];
+    uint32_t iteration = 0;
+    while (running) {
+      bool busy = false;
+
+      for (Client &client : clients) {
+        if (!client.region) {
+          continue;
+        }
+        uint32_t count = client.region->tx.Pop(buffer, 100);
+        if (count == 0) {
+          continue;
+        }
+        busy = true;
+        if (client.channel->transport->Transmit(buffer, count) != count) {
+          LOG_EVERY(Log::ERROR, 1000, "Transmit failed, channel {}",
+                    client.channel->channel);
+        }
+      }
+
+      for (Channel &channel : channels) {
+        DWORD count = channel.transport->Receive(buffer, 100, 0);
+        busy |= count > 0;
+        for (Client &client : clients) {
+          if (client.channel != &channel) {
+            continue;
+          }
+          for (DWORD i = 0; i < count; i++) {
+            if (Accept(client, buffer[i]) && !client.region->rx.Push(buffer[i])) {
+              client.region->rx_dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+          }
+        }
+      }
+
+      // 控制面每 64 轮或空闲时处理一次，避免每轮都进行系统调用
+      if (!busy || ++iteration % 64 == 0) {
+        Control(listen_fd, clients, channels);
+      }
+      if (!busy && idle_us > 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(idle_us));
+      }
+    }
+
+    for (Client &client : clients) {
+      Disconnect(client);
+    }
+    close(listen_fd);
+    unlink(socket_path);
+  } catch (const std::exception &e) {
+    Log::Flush();
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
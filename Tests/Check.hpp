@@ -0,0 +1,40 @@
+/**
+ * @file Check.hpp
+ * @author KalecKKK
+ * @brief 测试用的断言宏，失败时打印位置并计数，不中止
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * 每个测试是一个独立的可执行文件，main 返回 Check::Result()，
+ * 由 CTest 按返回值判定；返回 SKIP 表示环境不满足，跳过。
+ */
+
+#pragma once
+
+#include <cstdio>
+
+namespace Check {
+
+constexpr int SKIP = 77;
+
+inline int failures = 0;
+
+inline int Result() {
+  if (failures) {
+    fprintf(stderr, "%d check(s) failed\n", failures);
+  }
+  return failures ? 1 : 0;
+}
+
+} // namespace Check
+
+#define CHECK(condition)                                                       \
+  do {                                                                         \
+    if (!(condition)) {                                                        \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__,         \
+              #condition);                                                     \
+      ::Check::failures++;                                                     \
+    }                                                                          \
+  } while (0)
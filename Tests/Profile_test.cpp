@@ -0,0 +1,98 @@
+/**
+ * @file Profile_test.cpp
+ * @author KalecKKK
+ * @brief 梯形与双 S 速度曲线的边界：起止点、各段衔接处的连续性与限值
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "Check.hpp"
+#include "Trajectory.hpp"
+#include <cmath>
+
+using namespace Motor;
+
+namespace {
+
+/**
+ * @brief 密集采样整条曲线，相邻采样间的位移与速度变化不得超过限值，
+ *        段与段衔接处的跳变会被检出
+ */
+void CheckProfile(Profile_type type, double distance,
+                  const Profile_limits &limits) {
+  Motion_profile profile = Motion_profile::Plan(type, distance, limits);
+  double total = profile.Duration();
+  CHECK(total > 0);
+
+  double position, speed;
+  profile.Sample(0, position, speed);
+  CHECK(position == 0 && speed == 0);
+  profile.Sample(-1, position, speed);
+  CHECK(position == 0 && speed == 0);
+  profile.Sample(total, position, speed);
+  CHECK(position == distance && speed == 0);
+  profile.Sample(total + 1, position, speed);
+  CHECK(position == distance && speed == 0);
+
+  constexpr int STEPS = 200000;
+  constexpr double EPSILON = 1e-9;
+  double dt = total / STEPS;
+  double sign = distance < 0 ? -1 : 1;
+  double last_position = 0, last_speed = 0, last_acceleration = 0;
+  bool jerk_ok = true, acceleration_ok = true, speed_ok = true,
+       position_ok = true;
+  for (int i = 1; i <= STEPS; i++) {
+    profile.Sample(i * dt, position, speed);
+    double acceleration = (speed - last_speed) / dt;
+    position_ok &= sign * (position - last_position) >= -EPSILON &&
+                   std::fabs(position - last_position) <=
+                       limits.speed * dt + EPSILON;
+    speed_ok &= sign * speed >= -EPSILON &&
+                std::fabs(speed) <= limits.speed * (1 + EPSILON);
+    acceleration_ok &=
+        std::fabs(acceleration) <= limits.acceleration * (1 + 1e-6) + EPSILON;
+    // 梯形曲线的加速度本身是阶跃，只检查 S 形曲线的加加速度
+    if (type == PROFILE_S_CURVE && limits.jerk > 0 && i > 1) {
+      jerk_ok &= std::fabs(acceleration - last_acceleration) <=
+                 limits.jerk * dt * (1 + 1e-3) + 1e-6;
+    }
+    last_position = position;
+    last_speed = speed;
+    last_acceleration = acceleration;
+  }
+  CHECK(position_ok);
+  CHECK(speed_ok);
+  CHECK(acceleration_ok);
+  CHECK(jerk_ok);
+  CHECK(std::fabs(last_position - distance) <= EPSILON);
+}
+
+} // namespace
+
+int main() {
+  Profile_limits limits{2.0f, 8.0f, 64.0f};
+  for (Profile_type type : {PROFILE_TRAPEZOID, PROFILE_S_CURVE}) {
+    // 有匀速段、刚好达到最大速度、达不到最大速度
+    for (double distance : {3.0, 0.5, 0.05, 1e-4, -3.0, -0.05}) {
+      CheckProfile(type, distance, limits);
+    }
+  }
+
+  // 加加速度小，达到最大速度前到不了最大加速度（v * j < a * a）
+  CheckProfile(PROFILE_S_CURVE, 3.0, {2.0f, 8.0f, 4.0f});
+  CheckProfile(PROFILE_S_CURVE, 0.2, {2.0f, 8.0f, 4.0f});
+  // 加加速度不大于 0 时按梯形规划
+  CheckProfile(PROFILE_S_CURVE, 1.0, {2.0f, 8.0f, 0.0f});
+
+  // 位移为 0 或限值不合法时曲线为空，采样取终点
+  Motion_profile empty = Motion_profile::Plan(PROFILE_S_CURVE, 0.0, limits);
+  double position, speed;
+  empty.Sample(0.5, position, speed);
+  CHECK(empty.Duration() == 0 && position == 0 && speed == 0);
+  CHECK(Motion_profile::Plan(PROFILE_TRAPEZOID, 1.0, {0.0f, 8.0f})
+            .Duration() == 0);
+  return Check::Result();
+}
@@ -0,0 +1,141 @@
+/**
+ * @file Simd_test.cpp
+ * @author KalecKKK
+ * @brief 各级向量化内核与标量实现逐位一致，含尾部长度与 NaN、无穷大输入
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "Check.hpp"
+#include "Simd.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t MAX_LEN = 37; // 覆盖 8、4 的整倍数与各种尾部长度
+
+std::mt19937 generator(20261019);
+
+std::vector<float> Random(float low, float high) {
+  std::uniform_real_distribution<float> distribution(low, high);
+  std::vector<float> values(MAX_LEN);
+  for (float &value : values) {
+    value = distribution(generator);
+  }
+  return values;
+}
+
+/**
+ * @brief 把少量元素替换为 NaN 与无穷大
+ */
+void AddSpecials(std::vector<float> &values) {
+  values[3] = std::numeric_limits<float>::quiet_NaN();
+  values[11] = std::numeric_limits<float>::infinity();
+  values[20] = -std::numeric_limits<float>::infinity();
+  values[MAX_LEN - 1] = std::numeric_limits<float>::quiet_NaN();
+}
+
+bool Same(const std::vector<float> &a, const std::vector<float> &b) {
+  return memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+}
+
+template <typename Run> void Compare(const char *name, Run run) {
+  Simd::SetLevel(Simd::LEVEL_SCALAR);
+  for (uint32_t len = 0; len <= MAX_LEN; len++) {
+    std::vector<float> expected = run(len);
+    for (Simd::Level level : {Simd::LEVEL_SSE2, Simd::LEVEL_AVX2}) {
+      Simd::SetLevel(level);
+      if (!Same(run(len), expected)) {
+        fprintf(stderr, "%s differs at %s, len %u\n", name,
+                Simd::LevelName(Simd::GetLevel()), len);
+        CHECK(false);
+      }
+    }
+    Simd::SetLevel(Simd::LEVEL_SCALAR);
+  }
+}
+
+} // namespace
+
+int main() {
+  std::vector<int32_t> raw(MAX_LEN);
+  std::uniform_int_distribution<int32_t> raw_distribution(-(1 << 20), 1 << 20);
+  for (int32_t &value : raw) {
+    value = raw_distribution(generator);
+  }
+  Compare("Affine", [&](uint32_t len) {
+    std::vector<float> out(MAX_LEN);
+    Simd::Affine(raw.data(), out.data(), len, 0.0123f, -4.5f);
+    return out;
+  });
+
+  auto kp = Random(0, 10), ki = Random(0, 2), kd = Random(0, 1),
+       kaw = Random(0, 1), output_min = Random(-20, -1),
+       output_max = Random(1, 20), position_setpoint = Random(-5, 5),
+       speed_setpoint = Random(-5, 5), feedforward = Random(-2, 2),
+       position = Random(-5, 5), speed = Random(-5, 5);
+  AddSpecials(position_setpoint);
+  AddSpecials(feedforward);
+  output_min[7] = std::numeric_limits<float>::quiet_NaN();
+  output_max[9] = std::numeric_limits<float>::quiet_NaN();
+  auto initial_integral = Random(-1, 1);
+  Compare("Pid", [&](uint32_t len) {
+    std::vector<float> integral = initial_integral, output(MAX_LEN);
+    Simd::Pid_arrays arrays{kp.data(),
+                            ki.data(),
+                            kd.data(),
+                            kaw.data(),
+                            output_min.data(),
+                            output_max.data(),
+                            position_setpoint.data(),
+                            speed_setpoint.data(),
+                            feedforward.data(),
+                            position.data(),
+                            speed.data(),
+                            integral.data(),
+                            output.data()};
+    Simd::Pid(arrays, len, 0.001f);
+    output.insert(output.end(), integral.begin(), integral.end());
+    return output;
+  });
+
+  auto measured_position = Random(-5, 5), measured_speed = Random(-5, 5),
+       dt = Random(0, 0.01f), position_gain = Random(0, 1),
+       speed_gain = Random(0, 50), speed_weight = Random(0, 1);
+  AddSpecials(measured_position);
+  Compare("AlphaBeta", [&](uint32_t len) {
+    std::vector<float> estimate_position = position, estimate_speed = speed;
+    Simd::Alpha_beta_arrays arrays{measured_position.data(),
+                                   measured_speed.data(),
+                                   dt.data(),
+                                   position_gain.data(),
+                                   speed_gain.data(),
+                                   speed_weight.data(),
+                                   estimate_position.data(),
+                                   estimate_speed.data()};
+    Simd::AlphaBeta(arrays, len);
+    estimate_position.insert(estimate_position.end(), estimate_speed.begin(),
+                             estimate_speed.end());
+    return estimate_position;
+  });
+
+  auto lead = Random(0, 0.01f);
+  Compare("Extrapolate", [&](uint32_t len) {
+    std::vector<float> out(MAX_LEN);
+    Simd::Extrapolate(position_setpoint.data(), speed.data(), lead.data(),
+                      out.data(), len);
+    return out;
+  });
+
+  // SetLevel 不会高于 CPU 支持的指令集
+  Simd::SetLevel(Simd::LEVEL_AVX2);
+  printf("Compared scalar with %s\n", Simd::LevelName(Simd::GetLevel()));
+  return Check::Result();
+}
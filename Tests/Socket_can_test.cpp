@@ -0,0 +1,89 @@
+/**
+ * @file Socket_can_test.cpp
+ * @author KalecKKK
+ * @brief 在 vcan0 上检查 Socket_can_transport 的接收过滤与时间戳，没有 vcan0 时跳过
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *   ip link add dev vcan0 type vcan && ip link set up vcan0
+ */
+
+#include "Check.hpp"
+#include "Socket_can_transport.hpp"
+#include <ctime>
+#include <memory>
+#include <stdexcept>
+
+using namespace EcanVci;
+
+namespace {
+
+uint64_t MonotonicNow() {
+  timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
+CAN_OBJ Frame(UINT id) {
+  CAN_OBJ msg{};
+  msg.ID = id;
+  msg.DataLen = 2;
+  msg.Data[0] = static_cast<BYTE>(id >> 8);
+  msg.Data[1] = static_cast<BYTE>(id);
+  return msg;
+}
+
+/**
+ * @brief 发送 ID 1、2、3 与 0x7FF 各一帧，返回接收端收到的 ID 位图
+ */
+uint32_t Exchange(const Socket_can_transport &sender,
+                  const Can_backend_handle &receiver) {
+  CAN_OBJ msgs[4] = {Frame(0x01), Frame(0x02), Frame(0x03), Frame(0x7FF)};
+  CHECK(sender.Transmit(msgs, 4) == 4);
+
+  uint32_t seen = 0;
+  CAN_OBJ received[8];
+  uint64_t before = MonotonicNow();
+  DWORD count;
+  while ((count = receiver.Receive(received, 8, 20)) > 0) {
+    for (DWORD i = 0; i < count; i++) {
+      // vcan0 上可能有其他进程的帧，只记录本测试发送的 ID
+      UINT id = received[i].ID;
+      if (id == 0x7FF) {
+        seen |= 1u << 31;
+      } else if (id < 31) {
+        seen |= 1u << id;
+      }
+      // 软件时间戳换算到 CLOCK_MONOTONIC，与本机单调时钟相差不超过 1 s
+      uint64_t timestamp = receiver.Timestamp(received[i]);
+      CHECK(timestamp + 1000000 > before && timestamp < MonotonicNow() + 1000);
+    }
+  }
+  return seen;
+}
+
+} // namespace
+
+int main() {
+  std::unique_ptr<Socket_can_transport> sender, receiver;
+  try {
+    sender = std::make_unique<Socket_can_transport>("vcan0");
+    receiver = std::make_unique<Socket_can_transport>("vcan0");
+  } catch (const std::runtime_error &e) {
+    fprintf(stderr, "vcan0 unavailable (%s), skipped\n", e.what());
+    return Check::SKIP;
+  }
+  // 经类型擦除的句柄设置过滤，与 Async_executor::Attach 的路径相同
+  Can_backend_handle handle(*receiver);
+
+  CHECK(Exchange(*sender, handle) == (1u << 1 | 1u << 2 | 1u << 3 | 1u << 31));
+
+  CHECK(handle.SetFilter({0x01, 0x03}) == STATUS_OK);
+  CHECK(Exchange(*sender, handle) == (1u << 1 | 1u << 3 | 1u << 31));
+
+  CHECK(handle.SetFilter({}) == STATUS_OK);
+  CHECK(Exchange(*sender, handle) == (1u << 1 | 1u << 2 | 1u << 3 | 1u << 31));
+  return Check::Result();
+}
@@ -0,0 +1,104 @@
+/**
+ * @file Spsc_ring_test.cpp
+ * @author KalecKKK
+ * @brief Spsc_ring 的满/空边界与跨线程交接：顺序、不丢不重
+ * @version 0.1
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "Check.hpp"
+#include "Spsc_ring.hpp"
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace {
+
+constexpr uint32_t CAPACITY = 64;
+using Ring = Spsc_ring<uint64_t, CAPACITY>;
+
+void CheckBounds() {
+  auto ring = std::make_unique<Ring>();
+  ring->Reset();
+  uint64_t values[CAPACITY + 8];
+  for (uint32_t i = 0; i < CAPACITY + 8; i++) {
+    values[i] = i;
+  }
+  CHECK(ring->Empty());
+  uint64_t value;
+  CHECK(!ring->Pop(value));
+
+  // 满时只写入剩余空间
+  CHECK(ring->Push(values, CAPACITY + 8) == CAPACITY);
+  CHECK(ring->Size() == CAPACITY);
+  CHECK(!ring->Push(values[0]));
+
+  // 读出一部分后再写，下标越过 N 回绕
+  uint64_t out[CAPACITY];
+  CHECK(ring->Pop(out, 10) == 10);
+  CHECK(out[0] == 0 && out[9] == 9);
+  CHECK(ring->Push(values, 10) == 10);
+  CHECK(ring->Pop(out, CAPACITY) == CAPACITY);
+  bool ordered = true;
+  for (uint32_t i = 0; i < CAPACITY; i++) {
+    ordered &= out[i] == (i < CAPACITY - 10 ? i + 10 : i - (CAPACITY - 10));
+  }
+  CHECK(ordered);
+  CHECK(ring->Empty());
+}
+
+/**
+ * @brief 生产者与消费者各一个线程，批量大小不同，队列经常满或空
+ */
+void CheckHandoff() {
+  constexpr uint64_t COUNT = 2000000;
+  auto ring = std::make_unique<Ring>();
+  ring->Reset();
+
+  std::thread producer([&] {
+    uint64_t batch[7];
+    uint64_t next = 0;
+    uint32_t size = 1;
+    while (next < COUNT) {
+      uint32_t len =
+          static_cast<uint32_t>(std::min<uint64_t>(size, COUNT - next));
+      for (uint32_t i = 0; i < len; i++) {
+        batch[i] = next + i;
+      }
+      uint32_t pushed = ring->Push(batch, len);
+      next += pushed;
+      if (pushed == 0) {
+        std::this_thread::yield();
+      }
+      size = size % 7 + 1;
+    }
+  });
+
+  uint64_t expected = 0;
+  bool ordered = true;
+  uint64_t out[5];
+  while (expected < COUNT) {
+    uint32_t popped = ring->Pop(out, 5);
+    for (uint32_t i = 0; i < popped; i++) {
+      ordered &= out[i] == expected++;
+    }
+    if (popped == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  CHECK(ordered);
+  CHECK(expected == COUNT);
+  CHECK(ring->Empty());
+}
+
+} // namespace
+
+int main() {
+  CheckBounds();
+  CheckHandoff();
+  return Check::Result();
+}